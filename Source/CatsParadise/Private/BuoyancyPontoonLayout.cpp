@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BuoyancyPontoonLayout.h"
+
+void FBuoyancyPontoonLayout::Initialize(TConstArrayView<FVector> PontoonLocations)
+{
+	NumPontoons = PontoonLocations.Num();
+	bValid = false;
+	Centroid = FVector::ZeroVector;
+	WeightsA.Reset();
+	WeightsB.Reset();
+	WeightsC.Reset();
+
+	if (NumPontoons == 0) { return; }
+
+	for (const FVector& Pontoon : PontoonLocations)
+	{
+		Centroid += Pontoon;
+	}
+	Centroid /= NumPontoons;
+
+	// Relative to the centroid the X and Y sums are zero, so C is the mean height
+	// and A, B come from the 2x2 normal equations
+	double Sxx = 0.0;
+	double Sxy = 0.0;
+	double Syy = 0.0;
+	for (const FVector& Pontoon : PontoonLocations)
+	{
+		const double X = Pontoon.X - Centroid.X;
+		const double Y = Pontoon.Y - Centroid.Y;
+		Sxx += X * X;
+		Sxy += X * Y;
+		Syy += Y * Y;
+	}
+
+	const double Determinant = Sxx * Syy - Sxy * Sxy;
+	if (NumPontoons < 3 || Determinant <= UE_DOUBLE_KINDA_SMALL_NUMBER * FMath::Max(Sxx * Syy, 1.0))
+	{
+		return;
+	}
+
+	WeightsA.SetNumUninitialized(NumPontoons);
+	WeightsB.SetNumUninitialized(NumPontoons);
+	WeightsC.SetNumUninitialized(NumPontoons);
+	for (int32 Index = 0; Index < NumPontoons; Index++)
+	{
+		const double X = PontoonLocations[Index].X - Centroid.X;
+		const double Y = PontoonLocations[Index].Y - Centroid.Y;
+		WeightsA[Index] = (Syy * X - Sxy * Y) / Determinant;
+		WeightsB[Index] = (Sxx * Y - Sxy * X) / Determinant;
+		WeightsC[Index] = 1.0 / NumPontoons;
+	}
+
+	bValid = true;
+}
+
+FVector FBuoyancyPontoonLayout::SolvePlane(TConstArrayView<float> Heights) const
+{
+	if (!bValid || Heights.Num() != NumPontoons) { return FVector::ZeroVector; }
+
+	VectorRegister4Float SumA = VectorZeroFloat();
+	VectorRegister4Float SumB = VectorZeroFloat();
+	VectorRegister4Float SumC = VectorZeroFloat();
+
+	int32 Index = 0;
+	for (; Index + 4 <= NumPontoons; Index += 4)
+	{
+		const VectorRegister4Float Height = VectorLoad(&Heights[Index]);
+		SumA = VectorMultiplyAdd(Height, VectorLoad(&WeightsA[Index]), SumA);
+		SumB = VectorMultiplyAdd(Height, VectorLoad(&WeightsB[Index]), SumB);
+		SumC = VectorMultiplyAdd(Height, VectorLoad(&WeightsC[Index]), SumC);
+	}
+
+	alignas(16) float LanesA[4];
+	alignas(16) float LanesB[4];
+	alignas(16) float LanesC[4];
+	VectorStoreAligned(SumA, LanesA);
+	VectorStoreAligned(SumB, LanesB);
+	VectorStoreAligned(SumC, LanesC);
+
+	float A = (LanesA[0] + LanesA[1]) + (LanesA[2] + LanesA[3]);
+	float B = (LanesB[0] + LanesB[1]) + (LanesB[2] + LanesB[3]);
+	float C = (LanesC[0] + LanesC[1]) + (LanesC[2] + LanesC[3]);
+
+	for (; Index < NumPontoons; Index++)
+	{
+		A += Heights[Index] * WeightsA[Index];
+		B += Heights[Index] * WeightsB[Index];
+		C += Heights[Index] * WeightsC[Index];
+	}
+
+	return FVector(A, B, C);
+}
+
+FQuat FBuoyancyPontoonLayout::GetPlaneRotation(const FVector& Plane)
+{
+	const FVector Normal = FVector(-Plane.X, -Plane.Y, 1.f).GetSafeNormal();
+	return FQuat::FindBetweenNormals(FVector::UpVector, Normal);
+}
@@ -0,0 +1,205 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BuoyantInstancedStaticMeshComponent.h"
+
+#include "OceanFFTCalculator.h"
+#include "Async/ParallelFor.h"
+
+UBuoyantInstancedStaticMeshComponent::UBuoyantInstancedStaticMeshComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+
+	// no instance bodies to move every frame
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+void UBuoyantInstancedStaticMeshComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UpdateOceanSampler();
+	CaptureBuoyantInstances();
+}
+
+int32 UBuoyantInstancedStaticMeshComponent::AddBuoyantInstance(const FTransform& WorldTransform)
+{
+	const int32 InstanceIndex = AddInstance(WorldTransform, true);
+	AddAnchor(WorldTransform);
+	ResizeFrameBuffers();
+	return InstanceIndex;
+}
+
+void UBuoyantInstancedStaticMeshComponent::CaptureBuoyantInstances()
+{
+	PontoonLayout.Initialize(PontoonsLocations);
+
+	const int32 NumInstances = GetInstanceCount();
+	AnchorX.Reset(NumInstances);
+	AnchorY.Reset(NumInstances);
+	AnchorYaw.Reset(NumInstances);
+	AnchorYawSin.Reset(NumInstances);
+	AnchorYawCos.Reset(NumInstances);
+	AnchorScale.Reset(NumInstances);
+
+	for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; InstanceIndex++)
+	{
+		FTransform WorldTransform;
+		GetInstanceTransform(InstanceIndex, WorldTransform, true);
+		AddAnchor(WorldTransform);
+	}
+
+	ResizeFrameBuffers();
+}
+
+void UBuoyantInstancedStaticMeshComponent::AddAnchor(const FTransform& WorldTransform)
+{
+	const float Yaw = WorldTransform.Rotator().Yaw;
+	float YawSin;
+	float YawCos;
+	FMath::SinCos(&YawSin, &YawCos, FMath::DegreesToRadians(Yaw));
+
+	AnchorX.Add(WorldTransform.GetLocation().X);
+	AnchorY.Add(WorldTransform.GetLocation().Y);
+	AnchorYaw.Add(Yaw);
+	AnchorYawSin.Add(YawSin);
+	AnchorYawCos.Add(YawCos);
+	AnchorScale.Add(WorldTransform.GetScale3D());
+}
+
+void UBuoyantInstancedStaticMeshComponent::ResizeFrameBuffers()
+{
+	const int32 NumPontoons = FMath::Max(PontoonsLocations.Num(), 1);
+	SamplePoints.SetNumUninitialized(AnchorX.Num() * NumPontoons);
+	SampleDisplacements.SetNumUninitialized(AnchorX.Num() * NumPontoons);
+	InstanceTransforms.SetNum(AnchorX.Num());
+}
+
+void UBuoyantInstancedStaticMeshComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const int32 NumInstances = AnchorX.Num();
+	IOceanSamplerInterface* Sampler = UpdateOceanSampler();
+	if (Sampler == nullptr || NumInstances == 0) { return; }
+	if (bOnlyUpdateWhenRendered && !WasRecentlyRendered()) { return; }
+
+	OCEAN_SCOPE_CYCLE_COUNTER(BuoyantInstancesTick);
+
+	if (PontoonLayout.Num() != PontoonsLocations.Num() || SamplePoints.Num() != NumInstances * FMath::Max(PontoonsLocations.Num(), 1))
+	{
+		PontoonLayout.Initialize(PontoonsLocations);
+		ResizeFrameBuffers();
+	}
+
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumInstances, InstancesPerBatch);
+
+	ParallelFor(NumBatches, [&](int32 BatchIndex)
+	{
+		const int32 StartInstance = BatchIndex * InstancesPerBatch;
+		BuildSamplePoints(StartInstance, FMath::Min(StartInstance + InstancesPerBatch, NumInstances));
+	});
+
+	Sampler->GetOceanDisplacements(SamplePoints, SampleDisplacements);
+
+	ParallelFor(NumBatches, [&](int32 BatchIndex)
+	{
+		const int32 StartInstance = BatchIndex * InstancesPerBatch;
+		BuildInstanceTransforms(StartInstance, FMath::Min(StartInstance + InstancesPerBatch, NumInstances));
+	});
+
+	// the instance bodies only exist, and are only teleported along, with collision enabled
+	BatchUpdateInstancesTransforms(0, InstanceTransforms, true, true, IsCollisionEnabled());
+}
+
+void UBuoyantInstancedStaticMeshComponent::BuildSamplePoints(int32 StartInstance, int32 EndInstance)
+{
+	const int32 NumPontoons = FMath::Max(PontoonsLocations.Num(), 1);
+
+	for (int32 InstanceIndex = StartInstance; InstanceIndex < EndInstance; InstanceIndex++)
+	{
+		const float YawSin = AnchorYawSin[InstanceIndex];
+		const float YawCos = AnchorYawCos[InstanceIndex];
+		const FVector& Scale = AnchorScale[InstanceIndex];
+
+		for (int32 PontoonIndex = 0; PontoonIndex < NumPontoons; PontoonIndex++)
+		{
+			// pontoons scale with the instance, so a larger piece samples the waves over its larger footprint
+			const FVector Pontoon = PontoonsLocations.IsValidIndex(PontoonIndex) ? PontoonsLocations[PontoonIndex] * Scale : FVector::ZeroVector;
+			SamplePoints[InstanceIndex * NumPontoons + PontoonIndex] = FVector(
+				AnchorX[InstanceIndex] + YawCos * Pontoon.X - YawSin * Pontoon.Y,
+				AnchorY[InstanceIndex] + YawSin * Pontoon.X + YawCos * Pontoon.Y,
+				0.f
+			);
+		}
+	}
+}
+
+void UBuoyantInstancedStaticMeshComponent::BuildInstanceTransforms(int32 StartInstance, int32 EndInstance)
+{
+	const int32 NumPontoons = FMath::Max(PontoonsLocations.Num(), 1);
+	const FVector Centroid = PontoonLayout.GetCentroid();
+
+	TArray<float, TInlineAllocator<8>> PontoonHeights;
+	PontoonHeights.SetNumUninitialized(NumPontoons);
+
+	for (int32 InstanceIndex = StartInstance; InstanceIndex < EndInstance; InstanceIndex++)
+	{
+		const int32 FirstSample = InstanceIndex * NumPontoons;
+		const float YawSin = AnchorYawSin[InstanceIndex];
+		const float YawCos = AnchorYawCos[InstanceIndex];
+		const FVector& Scale = AnchorScale[InstanceIndex];
+		const FVector ScaledCentroid = Centroid * Scale;
+
+		// the horizontal wave displacement moves the whole instance, averaged over its pontoons
+		FVector2D HorizontalDisplacement = FVector2D::ZeroVector;
+		for (int32 PontoonIndex = 0; PontoonIndex < NumPontoons; PontoonIndex++)
+		{
+			const FVector& Displacement = SampleDisplacements[FirstSample + PontoonIndex];
+			HorizontalDisplacement += FVector2D(Displacement.X, Displacement.Y);
+			PontoonHeights[PontoonIndex] = Displacement.Z;
+		}
+		HorizontalDisplacement /= NumPontoons;
+
+		FRotator Rotation = FRotator::ZeroRotator;
+		float Height = PontoonHeights[0];
+		if (PontoonLayout.IsValid())
+		{
+			// the layout is unscaled, the heights were sampled over the scaled pontoons so the slopes shrink by the scale
+			FVector Plane = PontoonLayout.SolvePlane(PontoonHeights);
+			Plane.X = FMath::IsNearlyZero(Scale.X) ? 0.f : Plane.X / Scale.X;
+			Plane.Y = FMath::IsNearlyZero(Scale.Y) ? 0.f : Plane.Y / Scale.Y;
+			Rotation = FBuoyancyPontoonLayout::GetPlaneRotation(Plane).Rotator() * RotationStrength;
+			Height = Plane.Z;
+		}
+		Rotation.Yaw += AnchorYaw[InstanceIndex];
+
+		const FVector Location = FVector(
+			AnchorX[InstanceIndex] + YawCos * ScaledCentroid.X - YawSin * ScaledCentroid.Y + HorizontalDisplacement.X,
+			AnchorY[InstanceIndex] + YawSin * ScaledCentroid.X + YawCos * ScaledCentroid.Y + HorizontalDisplacement.Y,
+			Height
+		);
+
+		InstanceTransforms[InstanceIndex] = FTransform(Rotation, Location, AnchorScale[InstanceIndex]);
+	}
+}
+
+IOceanSamplerInterface* UBuoyantInstancedStaticMeshComponent::UpdateOceanSampler()
+{
+	// looked up again when the backend is switched at runtime or the ocean it found was destroyed,
+	// a world without any ocean isn't searched again every tick
+	const EOceanSamplingBackend Backend = IOceanSamplerInterface::GetSamplingBackend();
+	if (bOceanSamplerSearched && Backend == OceanSamplerBackend && !OceanSampler.IsStale())
+	{
+		return OceanSampler.Get();
+	}
+
+	OceanSamplerBackend = Backend;
+	OceanSampler = IOceanSamplerInterface::FindOceanSampler(GetWorld());
+	bOceanSamplerSearched = true;
+
+	if (!OceanSampler.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("WaterZone isn't valid"));
+	}
+	return OceanSampler.Get();
+}
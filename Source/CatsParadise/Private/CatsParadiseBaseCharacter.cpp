@@ -1,5 +1,6 @@
 ﻿#include "CatsParadiseBaseCharacter.h"
 #include "PickupActor.h"
+#include "PlayerFocusSubsystem.h"
 #include "Components/CapsuleComponent.h"
 
 ACatsParadiseBaseCharacter::ACatsParadiseBaseCharacter()
@@ -16,6 +17,16 @@ void ACatsParadiseBaseCharacter::BeginPlay()
 	Super::BeginPlay();
 }
 
+void ACatsParadiseBaseCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(UPlayerFocusSubsystem* FocusSubsystem = UWorld::GetSubsystem<UPlayerFocusSubsystem>(GetWorld()))
+	{
+		FocusSubsystem->RemoveViewer(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ACatsParadiseBaseCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -117,32 +128,22 @@ AActor* ACatsParadiseBaseCharacter::GetCharacterInView()
 		return nullptr;
 	}
 
-	const FVector TraceStart {ViewLocation};
-	const FVector TraceDirection {ViewRotation.Vector()};
-	const FVector TraceEnd {TraceStart + TraceDirection * SightDistance};
-
-	if(!GetWorld())
+	UPlayerFocusSubsystem* FocusSubsystem = UWorld::GetSubsystem<UPlayerFocusSubsystem>(GetWorld());
+	if(!FocusSubsystem)
 	{
 		UE_LOG(LogTemp, Display, TEXT("No World"));
 		return nullptr;
 	}
 
-	FHitResult HitResult;
-
-	UKismetSystemLibrary::LineTraceSingle(GetWorld(),
-		TraceStart,
-		TraceEnd,
-		TraceChannel,
-		false,
-		{this},
-		DebugTrace,
-		HitResult,
-		true,
-		FLinearColor::Red,
-		FLinearColor::Green,
-		DebugDrawTime);
-	
-	return HitResult.GetActor();
+	// a line trace, shared with the interaction queue only when its sight settings are the same,
+	// a sweep would find actors the line misses
+	FPlayerFocusTraceSettings Settings;
+	Settings.TraceChannel = TraceChannel;
+	Settings.Distance = SightDistance;
+	Settings.DebugTrace = DebugTrace;
+	Settings.DebugDrawTime = DebugDrawTime;
+
+	return FocusSubsystem->GetFocusedActor(this, ViewLocation, ViewRotation, Settings);
 }
 
 bool ACatsParadiseBaseCharacter::GetPlayerViewport(FVector& ViewLocation, FRotator& ViewRotation)
@@ -156,7 +157,14 @@ bool ACatsParadiseBaseCharacter::GetPlayerViewport(FVector& ViewLocation, FRotat
 			return false;
 		}
 
-		CharacterController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		if(UPlayerFocusSubsystem* FocusSubsystem = UWorld::GetSubsystem<UPlayerFocusSubsystem>(GetWorld()))
+		{
+			FocusSubsystem->GetPlayerViewPoint(CharacterController, ViewLocation, ViewRotation);
+		}
+		else
+		{
+			CharacterController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		}
 	}
 
 	return true;
@@ -2,8 +2,15 @@
 
 #include "CatsParadiseBuoyancyComponent.h"
 
-#include "Kismet/GameplayStatics.h"
+#include "OceanFFTCalculator.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "GameFramework/PlayerController.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buoyancy Evaluations"), STAT_BuoyancyEvaluations, STATGROUP_Ocean);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buoyancy Scratch Allocations"), STAT_BuoyancyScratchAllocations, STATGROUP_Ocean);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Buoyancy Skipped Transform Updates"), STAT_BuoyancySkippedTransformUpdates, STATGROUP_Ocean);
 
 // Sets default values for this component's properties
 UCatsParadiseBuoyancyComponent::UCatsParadiseBuoyancyComponent()
@@ -25,8 +32,36 @@ void UCatsParadiseBuoyancyComponent::BeginPlay()
 		RelativeStaticMeshLocation = MyStaticMeshComponent->GetRelativeLocation();
 		RelativeStaticMeshRotation = MyStaticMeshComponent->GetRelativeRotation();
 	}
+	UpdateOceanSampler();
+	PontoonLayout.Initialize(PontoonsLocations);
+
+	if (BuoyancyMode == EBuoyancyMode::Physics)
+	{
+		if (!MyStaticMeshComponent->IsValidLowLevelFast() || !MyStaticMeshComponent->IsSimulatingPhysics())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: physics buoyancy needs a static mesh that simulates physics"), *GetNameSafe(ParentActor));
+			BuoyancyMode = EBuoyancyMode::Kinematic;
+		}
+		else if (!UPhysicsSettings::Get()->bTickPhysicsAsync)
+		{
+			// the forces are applied from AsyncPhysicsTickComponent, which only runs with async physics ticking
+			UE_LOG(LogTemp, Warning, TEXT("%s: physics buoyancy needs Tick Async Physics enabled in the physics settings"), *GetNameSafe(ParentActor));
+			BuoyancyMode = EBuoyancyMode::Kinematic;
+		}
+		else
+		{
+			// pontoons are authored relative to the actor, the simulated mesh moves on its own
+			const FTransform& MeshTransform = MyStaticMeshComponent->GetComponentTransform();
+			for (const FVector& Pontoon : PontoonsLocations)
+			{
+				MeshPontoonOffsets.Add(MeshTransform.InverseTransformPosition(ActorTransform.TransformPosition(Pontoon)));
+			}
+			SetAsyncPhysicsTickEnabled(true);
+			return;
+		}
+	}
+
 	ParentActor->SetActorLocation(FVector(WorldActorLocation.X, WorldActorLocation.Y, 0));
-	FFTCalculator = InitializeWaterZoneReference();
 }
 
 // Called every frame
@@ -36,52 +71,279 @@ void UCatsParadiseBuoyancyComponent::TickComponent(float DeltaTime, ELevelTick T
 
 	if (bWaterZoneValid)
 	{
+		UpdateOceanSampler();
+		// the sampler can go away when the backend is switched
+		if (!bWaterZoneValid) { return; }
+
+		OCEAN_SCOPE_CYCLE_COUNTER(BuoyancyTick);
+
+		if (BuoyancyMode == EBuoyancyMode::Physics)
+		{
+			UpdateSignificance();
+			const float WorldTime = GetWorld()->GetTimeSeconds();
+			if (Significance != EBuoyancySignificance::Paused && (LastSample.Time < 0.f || WorldTime - LastSample.Time >= GetSampleInterval()))
+			{
+				LastSample.Time = WorldTime;
+				SamplePhysicsSurfaceHeights();
+			}
+			return;
+		}
+
 		if (ActorTransform.GetLocation() != ParentActor->GetActorLocation())
 		{
 			ActorTransform = ParentActor->GetActorTransform();
 			WorldActorLocation = ParentActor->GetActorLocation();
 			WorldActorRotation = ParentActor->GetActorRotation();
 			ParentActor->SetActorLocation(FVector(WorldActorLocation.X, WorldActorLocation.Y, 0));
+			// samples taken at the old location can't be extrapolated from
+			ResetBuoyancySamples();
 		}
 
-		if (PontoonsLocations.Num() > 2)
+		UpdateSignificance();
+		if (Significance == EBuoyancySignificance::Paused) { return; }
+
+		const float WorldTime = GetWorld()->GetTimeSeconds();
+		if (LastSample.Time < 0.f || WorldTime - LastSample.Time >= GetSampleInterval())
 		{
-			const TArray<FVector> BuoyancyArray = GetBuoyancyArray(PontoonsLocations);
-			const FQuat ActorQuat = CalculateBuoyancyRotation(BuoyancyArray);
-			const FVector BuoyancyLocation = GetMultiBuoyancyLocation(PontoonsLocations);
-			const FRotator BuoyancyRotation = ActorQuat.Rotator() * RotationStrength + WorldActorRotation;
+			SampleBuoyancy(WorldTime);
+		}
 
-			if (MyStaticMeshComponent->IsValidLowLevelFast())
-			{
-				MyStaticMeshComponent->SetWorldLocation(BuoyancyLocation);
-				MyStaticMeshComponent->SetWorldRotation(BuoyancyRotation);
-			}
+		ApplyBuoyancyTransform(WorldTime);
+	}
+}
 
-			if (DebugPoints) { DrawBuoyancyArrayDebugPoints(BuoyancyArray); }
-		}
-		else
+void UCatsParadiseBuoyancyComponent::SampleBuoyancy(float WorldTime)
+{
+	PreviousSample = LastSample;
+	LastSample.Time = WorldTime;
+
+	INC_DWORD_STAT(STAT_BuoyancyEvaluations);
+
+	if (PontoonsLocations.Num() > 2)
+	{
+		ResizeScratch(BuoyancyPoints, PontoonsLocations.Num());
+		GetBuoyancyLocations(PontoonsLocations, BuoyancyPoints);
+
+		const FQuat WaveQuat = CalculateBuoyancyRotation(BuoyancyPoints);
+		const FRotator BuoyancyRotation = WaveQuat.Rotator() * RotationStrength + WorldActorRotation;
+
+		LastSample.Location = GetBuoyancyLocation(PontoonLayout.GetCentroid());
+		LastSample.Rotation = BuoyancyRotation.Quaternion();
+
+		if (DebugPoints) { DrawBuoyancyArrayDebugPoints(BuoyancyPoints); }
+	}
+	else
+	{
+		LastSample.Location = GetBuoyancyLocation(PontoonsLocations[0]);
+		LastSample.Rotation = FQuat::Identity;
+	}
+}
+
+void UCatsParadiseBuoyancyComponent::ApplyBuoyancyTransform(float WorldTime)
+{
+	if (!MyStaticMeshComponent->IsValidLowLevelFast()) { return; }
+
+	FVector BuoyancyLocation = LastSample.Location;
+	FQuat BuoyancyRotation = LastSample.Rotation;
+
+	// Between throttled samples keep moving along the last sampled motion,
+	// at most one sample period ahead so a stale pair can't overshoot
+	const float SampleDelta = LastSample.Time - PreviousSample.Time;
+	if (WorldTime > LastSample.Time && PreviousSample.Time >= 0.f && SampleDelta > KINDA_SMALL_NUMBER)
+	{
+		const float Alpha = FMath::Min((WorldTime - LastSample.Time) / SampleDelta, 1.f);
+		BuoyancyLocation += (LastSample.Location - PreviousSample.Location) * Alpha;
+
+		const FQuat RotationDelta = LastSample.Rotation * PreviousSample.Rotation.Inverse();
+		BuoyancyRotation = FQuat::Slerp(FQuat::Identity, RotationDelta, Alpha) * LastSample.Rotation;
+	}
+
+	if (PontoonsLocations.Num() <= 2)
+	{
+		BuoyancyRotation = MyStaticMeshComponent->GetComponentQuat();
+	}
+
+	// Every move dirties the render state and propagates to attached components,
+	// so sub-threshold changes in calm water are dropped
+	if (bHasAppliedTransform
+		&& BuoyancyLocation.Equals(LastAppliedLocation, LocationUpdateThreshold)
+		&& BuoyancyRotation.AngularDistance(LastAppliedRotation) <= FMath::DegreesToRadians(RotationUpdateThreshold))
+	{
+		INC_DWORD_STAT(STAT_BuoyancySkippedTransformUpdates);
+		return;
+	}
+
+	// Never sweep, and teleport so a simulated body doesn't pick up velocity from the move
+	MyStaticMeshComponent->SetWorldLocationAndRotation(BuoyancyLocation, BuoyancyRotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+	bHasAppliedTransform = true;
+	LastAppliedLocation = BuoyancyLocation;
+	LastAppliedRotation = BuoyancyRotation;
+}
+
+void UCatsParadiseBuoyancyComponent::SamplePhysicsSurfaceHeights()
+{
+	INC_DWORD_STAT(STAT_BuoyancyEvaluations);
+
+	const int32 NumPontoons = MeshPontoonOffsets.Num();
+	const FTransform MeshTransform = MyStaticMeshComponent->GetComponentTransform();
+
+	ResizeScratch(PontoonGridPoints, NumPontoons);
+	ResizeScratch(PontoonDisplacements, NumPontoons);
+	for (int32 Index = 0; Index < NumPontoons; Index++)
+	{
+		const FVector WorldLocation = MeshTransform.TransformPosition(MeshPontoonOffsets[Index]);
+		PontoonGridPoints[Index] = FVector(WorldLocation.X, WorldLocation.Y, 0.f);
+	}
+
+	IOceanSamplerInterface* Sampler = OceanSampler.Get();
+	if (Sampler != nullptr)
+	{
+		Sampler->GetOceanDisplacements(PontoonGridPoints, PontoonDisplacements);
+	}
+
+	FScopeLock Lock(&PhysicsInputLock);
+	PhysicsInput.PontoonOffsets = MeshPontoonOffsets;
+	PhysicsInput.SurfaceHeights.SetNumUninitialized(NumPontoons, false);
+	for (int32 Index = 0; Index < NumPontoons; Index++)
+	{
+		PhysicsInput.SurfaceHeights[Index] = Sampler != nullptr ? PontoonDisplacements[Index].Z : 0.f;
+	}
+	PhysicsInput.GravityZ = GetWorld()->GetGravityZ();
+	PhysicsInput.BuoyancyCoefficient = BuoyancyCoefficient;
+	PhysicsInput.PontoonRadius = FMath::Max(PontoonRadius, 1.f);
+	PhysicsInput.WaterDrag = WaterDrag;
+	PhysicsInput.VerticalDamping = VerticalDamping;
+
+	if (DebugPoints)
+	{
+		for (int32 Index = 0; Index < NumPontoons; Index++)
 		{
-			if (MyStaticMeshComponent->IsValidLowLevelFast())
-			{
-				const FVector BuoyancyLocation = GetBuoyancyLocation(PontoonsLocations[0]);
-				MyStaticMeshComponent->SetWorldLocation(BuoyancyLocation);
-			}
+			DrawDebugPoint(GetWorld(), FVector(PontoonGridPoints[Index].X, PontoonGridPoints[Index].Y, PhysicsInput.SurfaceHeights[Index]), 50.f, FColor(0.f, 0.f, 255.f, 255.f), false, 0.f, 0);
 		}
 	}
 }
 
+void UCatsParadiseBuoyancyComponent::AsyncPhysicsTickComponent(float DeltaTime, float SimTime)
+{
+	Super::AsyncPhysicsTickComponent(DeltaTime, SimTime);
+
+	if (BuoyancyMode != EBuoyancyMode::Physics || !MyStaticMeshComponent) { return; }
+
+	FBodyInstance* BodyInstance = MyStaticMeshComponent->GetBodyInstance();
+	if (!BodyInstance || !BodyInstance->GetPhysicsActorHandle()) { return; }
+
+	Chaos::FRigidBodyHandle_Internal* RigidHandle = BodyInstance->GetPhysicsActorHandle()->GetPhysicsThreadAPI();
+	if (!RigidHandle || RigidHandle->ObjectState() != Chaos::EObjectStateType::Dynamic) { return; }
+
+	FBuoyancyPhysicsInput Input;
+	{
+		FScopeLock Lock(&PhysicsInputLock);
+		Input = PhysicsInput;
+	}
+
+	const int32 NumPontoons = Input.PontoonOffsets.Num();
+	if (NumPontoons == 0 || Input.SurfaceHeights.Num() != NumPontoons) { return; }
+
+	const FTransform BodyTransform(RigidHandle->R(), RigidHandle->X());
+	const FVector CenterOfMass = BodyTransform.TransformPosition(RigidHandle->CenterOfMass());
+	const FVector LinearVelocity = RigidHandle->V();
+	const FVector AngularVelocity = RigidHandle->W();
+	const float PontoonMass = RigidHandle->M() / NumPontoons;
+
+	FVector TotalForce = FVector::ZeroVector;
+	FVector TotalTorque = FVector::ZeroVector;
+	for (int32 Index = 0; Index < NumPontoons; Index++)
+	{
+		const FVector PontoonLocation = BodyTransform.TransformPosition(Input.PontoonOffsets[Index]);
+		const float Depth = Input.SurfaceHeights[Index] - PontoonLocation.Z;
+		if (Depth <= 0.f) { continue; }
+
+		const float Submerged = FMath::Min(Depth / Input.PontoonRadius, 1.f);
+		const FVector Arm = PontoonLocation - CenterOfMass;
+		const FVector PointVelocity = LinearVelocity + FVector::CrossProduct(AngularVelocity, Arm);
 
+		FVector Force = FVector(0.f, 0.f, -Input.GravityZ * Input.BuoyancyCoefficient);
+		Force -= FVector(PointVelocity.X, PointVelocity.Y, 0.f) * Input.WaterDrag;
+		Force -= FVector(0.f, 0.f, PointVelocity.Z) * Input.VerticalDamping;
+		Force *= PontoonMass * Submerged;
+
+		TotalForce += Force;
+		TotalTorque += FVector::CrossProduct(Arm, Force);
+	}
+
+	RigidHandle->AddForce(TotalForce);
+	RigidHandle->AddTorque(TotalTorque);
+}
+
+void UCatsParadiseBuoyancyComponent::ResetBuoyancySamples()
+{
+	LastSample = FBuoyancySample();
+	PreviousSample = FBuoyancySample();
+	bHasAppliedTransform = false;
+}
+
+EBuoyancySignificance UCatsParadiseBuoyancyComponent::CalculateSignificance() const
+{
+	if (!bUseSignificanceThrottling) { return EBuoyancySignificance::Full; }
+
+	const FVector Location = ParentActor->GetActorLocation();
+	float ClosestDistanceSquared = TNumericLimits<float>::Max();
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (!PlayerController) { continue; }
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(Location, ViewLocation));
+	}
+
+	if (ClosestDistanceSquared <= FMath::Square(FullRateDistance)) { return EBuoyancySignificance::Full; }
+	if (ClosestDistanceSquared <= FMath::Square(ReducedRateDistance)) { return EBuoyancySignificance::Reduced; }
+
+	const bool bRendered = MyStaticMeshComponent->IsValidLowLevelFast() && MyStaticMeshComponent->WasRecentlyRendered(RecentlyRenderedTolerance);
+	return bRendered ? EBuoyancySignificance::Distant : EBuoyancySignificance::Paused;
+}
+
+void UCatsParadiseBuoyancyComponent::UpdateSignificance()
+{
+	const EBuoyancySignificance NewSignificance = CalculateSignificance();
+	if (NewSignificance == Significance) { return; }
+
+	// a paused component only wakes up to re-evaluate, the others tick every frame and
+	// throttle the ocean sampling instead so the mesh keeps moving smoothly
+	SetComponentTickInterval(NewSignificance == EBuoyancySignificance::Paused ? PausedCheckInterval : 0.f);
+	if (Significance == EBuoyancySignificance::Paused) { ResetBuoyancySamples(); }
+
+	Significance = NewSignificance;
+}
+
+float UCatsParadiseBuoyancyComponent::GetSampleInterval() const
+{
+	switch (Significance)
+	{
+	case EBuoyancySignificance::Reduced:
+		return ReducedSampleInterval;
+	case EBuoyancySignificance::Distant:
+		return DistantSampleInterval;
+	default:
+		return 0.f;
+	}
+}
 
 FVector UCatsParadiseBuoyancyComponent::GetBuoyancyLocation(FVector RelativeLocation)
 {
 	FVector BuoyancyLocation = FVector::ZeroVector;
 	FVector WorldLocation = ActorTransform.TransformPosition(RelativeLocation);
-	if (FFTCalculator == nullptr) { return BuoyancyLocation; }
+	IOceanSamplerInterface* Sampler = OceanSampler.Get();
+	if (Sampler == nullptr) { return BuoyancyLocation; }
 	else {
 
 		//FVector GridPointLocation = FVector(WorldLocation.X, WorldLocation.Y, -RelativeLocation.Z) / FFTCalculator->Scale * FFTCalculator->MultiplyScale;
 		FVector GridPointLocation = FVector(WorldLocation.X, WorldLocation.Y, -RelativeLocation.Z) ;
-		FVector Displacement = FFTCalculator->GetDisplacementAtPoint(GridPointLocation);
+		FVector Displacement = Sampler->GetOceanDisplacement(GridPointLocation);
 		
 		//BuoyancyLocation = GridPointLocation * FFTCalculator->Scale / FFTCalculator->MultiplyScale + Displacement / FFTCalculator->Scale / FFTCalculator->OverlapScale;
 		BuoyancyLocation = GridPointLocation + Displacement;
@@ -90,7 +352,35 @@ FVector UCatsParadiseBuoyancyComponent::GetBuoyancyLocation(FVector RelativeLoca
 	}
 }
 
-FVector UCatsParadiseBuoyancyComponent::GetMultiBuoyancyLocation(TArray<FVector> PontoonsArray)
+void UCatsParadiseBuoyancyComponent::GetBuoyancyLocations(TConstArrayView<FVector> RelativeLocations, TArrayView<FVector> OutLocations)
+{
+	check(RelativeLocations.Num() == OutLocations.Num());
+
+	IOceanSamplerInterface* Sampler = OceanSampler.Get();
+	if (Sampler == nullptr)
+	{
+		for (FVector& Location : OutLocations) { Location = FVector::ZeroVector; }
+		return;
+	}
+
+	ResizeScratch(PontoonGridPoints, RelativeLocations.Num());
+	ResizeScratch(PontoonDisplacements, RelativeLocations.Num());
+
+	for (int32 Index = 0; Index < RelativeLocations.Num(); Index++)
+	{
+		const FVector WorldLocation = ActorTransform.TransformPosition(RelativeLocations[Index]);
+		PontoonGridPoints[Index] = FVector(WorldLocation.X, WorldLocation.Y, -RelativeLocations[Index].Z);
+	}
+
+	Sampler->GetOceanDisplacements(PontoonGridPoints, PontoonDisplacements);
+
+	for (int32 Index = 0; Index < RelativeLocations.Num(); Index++)
+	{
+		OutLocations[Index] = PontoonGridPoints[Index] + PontoonDisplacements[Index];
+	}
+}
+
+FVector UCatsParadiseBuoyancyComponent::GetMultiBuoyancyLocation(const TArray<FVector>& PontoonsArray)
 {
 	FVector BuoyancyLocation = FVector::ZeroVector;
 	FVector AveragePontoons = FindAverageLocation(PontoonsArray);
@@ -101,31 +391,27 @@ FVector UCatsParadiseBuoyancyComponent::GetMultiBuoyancyLocation(TArray<FVector>
 
 
 
-FOceanFFTCalculator* UCatsParadiseBuoyancyComponent::InitializeWaterZoneReference()
+void UCatsParadiseBuoyancyComponent::UpdateOceanSampler()
 {
-	TArray<AActor*> FoundActors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AOceanWaterZone::StaticClass(), FoundActors);
+	// the backend can be switched at runtime, so the sampler is looked up again whenever it changes
+	const EOceanSamplingBackend Backend = IOceanSamplerInterface::GetSamplingBackend();
+	if (OceanSampler.IsValid() && Backend == OceanSamplerBackend) { return; }
+
+	OceanSamplerBackend = Backend;
+	OceanSampler = IOceanSamplerInterface::FindOceanSampler(GetWorld());
+	ResetBuoyancySamples();
 
-	if (FoundActors.Num() > 0)
+	bWaterZoneValid = OceanSampler.IsValid();
+	if (!bWaterZoneValid)
 	{
-		for (AActor* FoundActor : FoundActors)
-		{
-			OceanWaterZone = Cast<AOceanWaterZone>(FoundActor);
-			if (OceanWaterZone)
-			{
-				return &OceanWaterZone->FFTCalculator;
-			}
-		}
+		UE_LOG(LogTemp, Warning, TEXT("WaterZone isn't valid"));
 	}
-	bWaterZoneValid = false;
-	UE_LOG(LogTemp, Warning, TEXT("WaterZone isn't valid"));
-	return nullptr;
 }
 
-FVector UCatsParadiseBuoyancyComponent::FindAverageLocation(TArray<FVector> Locations)
+FVector UCatsParadiseBuoyancyComponent::FindAverageLocation(TConstArrayView<FVector> Locations)
 {
 	FVector AverageLocation = FVector::ZeroVector;
-	for (FVector& Location : Locations)
+	for (const FVector& Location : Locations)
 	{
 		AverageLocation = AverageLocation + Location;
 	}
@@ -133,43 +419,44 @@ FVector UCatsParadiseBuoyancyComponent::FindAverageLocation(TArray<FVector> Loca
 	return AverageLocation;
 }
 
-TArray<FVector> UCatsParadiseBuoyancyComponent::GetBuoyancyArray(TArray<FVector> Points)
+TArray<FVector> UCatsParadiseBuoyancyComponent::GetBuoyancyArray(const TArray<FVector>& Points)
 {
-	TArray<FVector> PointArray = {};
-	for (FVector& Point : Points)
-	{
-		PointArray.Add(GetBuoyancyLocation(Point));
-	}
+	TArray<FVector> PointArray;
+	PointArray.SetNumUninitialized(Points.Num());
+	GetBuoyancyLocations(Points, PointArray);
 	return PointArray;
 }
 
-FQuat UCatsParadiseBuoyancyComponent::CalculateBuoyancyRotation(const TArray<FVector> Points)
+template<typename TScratchArray>
+void UCatsParadiseBuoyancyComponent::ResizeScratch(TScratchArray& Scratch, int32 Num)
 {
-	FQuat AverageRotation = FQuat::Identity;
-
-	for (const FVector& WavePoint : Points)
+	// only growing past the inline capacity or the previous peak touches the heap
+	if (Num > Scratch.Max())
 	{
-		float DistanceToCenter = FVector::Dist(ParentActor->GetActorLocation(), WavePoint);
-		float Weight = 1.0f / (DistanceToCenter + SMALL_NUMBER); 
-
-		FQuat WaveRotation = CalculateWaveRotation(WavePoint);
-
-		// Accumulate the weighted rotation
-		AverageRotation = FQuat::Slerp(AverageRotation, WaveRotation, Weight);
+		INC_DWORD_STAT(STAT_BuoyancyScratchAllocations);
 	}
-	return AverageRotation;
+	Scratch.SetNumUninitialized(Num, false);
 }
 
-FQuat UCatsParadiseBuoyancyComponent::CalculateWaveRotation(const FVector& WavePoint)
+FQuat UCatsParadiseBuoyancyComponent::CalculateBuoyancyRotation(TConstArrayView<FVector> Points)
 {
-	FVector TargetVector(0.0f, 0.0f, 1.0f);
-	FVector WaveDirection = (WavePoint - ParentActor->GetActorLocation()).GetSafeNormal();
-	FQuat WaveRotation = FQuat::FindBetween(WaveDirection, TargetVector);
+	if (PontoonLayout.Num() != PontoonsLocations.Num())
+	{
+		PontoonLayout.Initialize(PontoonsLocations);
+	}
+	if (!PontoonLayout.IsValid() || Points.Num() != PontoonLayout.Num()) { return FQuat::Identity; }
+
+	// Fit the wave surface itself, buoyancy points are lowered by the pontoon's own height
+	ResizeScratch(PontoonHeights, Points.Num());
+	for (int32 Index = 0; Index < Points.Num(); Index++)
+	{
+		PontoonHeights[Index] = Points[Index].Z + PontoonsLocations[Index].Z;
+	}
 
-	return WaveRotation;
+	return FBuoyancyPontoonLayout::GetPlaneRotation(PontoonLayout.SolvePlane(PontoonHeights));
 }
 
-void UCatsParadiseBuoyancyComponent::DrawBuoyancyArrayDebugPoints(const TArray<FVector>& BuoyancyArray)
+void UCatsParadiseBuoyancyComponent::DrawBuoyancyArrayDebugPoints(TConstArrayView<FVector> BuoyancyArray)
 {
 	for (const FVector& Point : BuoyancyArray)
 	{
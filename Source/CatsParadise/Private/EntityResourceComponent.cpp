@@ -12,6 +12,34 @@ void UEntityResourceComponent::BeginPlay()
 	Super::BeginPlay();
 
 	ResourceData.Value = ResourceData.bUseCustomInitialValue ? ResourceData.InitialValue : ResourceData.MaxValue;
+
+	ResourceSubsystem = UWorld::GetSubsystem<UEntityResourceSubsystem>(GetWorld());
+	if(ResourceSubsystem)
+	{
+		ResourceHandle = ResourceSubsystem->AddResource(this, ResourceData.Value, ResourceData.MaxValue);
+		ResourceSubsystem->SetRate(ResourceHandle, ResourceData.Rate);
+
+		// on clients the server's state may have arrived before the component began play
+		ResourceSubsystem->ApplyReceivedState(this);
+	}
+}
+
+void UEntityResourceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(ResourceSubsystem)
+	{
+		FlushNotifications();
+
+		// keep the last values readable after the component left play
+		ResourceData.Value = GetValue();
+		ResourceData.MaxValue = GetMaxValue();
+		ResourceData.Rate = GetRate();
+		ResourceSubsystem->RemoveResource(ResourceHandle);
+		ResourceSubsystem = nullptr;
+	}
+	ResourceHandle = FEntityResourceHandle();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UEntityResourceComponent::InitializeComponent()
@@ -21,24 +49,26 @@ void UEntityResourceComponent::InitializeComponent()
 	ResourceData.Value = ResourceData.bUseCustomInitialValue ? ResourceData.InitialValue : ResourceData.MaxValue;
 }
 
-
-void UEntityResourceComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-}
-
 bool UEntityResourceComponent::DecreaseValue(const int32 Amount)
 {
-	if(Amount <= 0 || ResourceData.Value <= 0)
+	int32 Value = GetValue();
+	if(Amount <= 0 || Value <= 0)
 	{
 		return false;
 	}
 
-	ResourceData.Value -= Amount;
-	ResourceData.Value = FMath::Max(ResourceData.Value, 0);
-	OnValueDecreased.Broadcast(ResourceData.Value, Amount);
+	const bool bDeferred = DeferNotification();
+	Value -= Amount;
+	Value = FMath::Max(Value, 0);
+	SetStoredValue(Value);
+	if(bDeferred)
+	{
+		return true;
+	}
+
+	OnValueDecreased.Broadcast(Value, Amount);
 
-	if(ResourceData.Value == 0)
+	if(Value == 0)
 	{
 		OnValueZero.Broadcast();
 	}
@@ -48,36 +78,50 @@ bool UEntityResourceComponent::DecreaseValue(const int32 Amount)
 
 bool UEntityResourceComponent::IncreaseValue(const int32 Amount, bool bClampToMax)
 {
-	if(Amount <= 0 || ResourceData.Value >= ResourceData.MaxValue && bClampToMax)
+	int32 Value = GetValue();
+	const int32 MaxValue = GetMaxValue();
+	if(Amount <= 0 || Value >= MaxValue && bClampToMax)
 	{
 		return false;
 	}
 
-	ResourceData.Value += Amount;
+	const bool bDeferred = DeferNotification();
+	Value += Amount;
 
 	if(bClampToMax)
 	{
-		ResourceData.Value = FMath::Min(ResourceData.Value, ResourceData.MaxValue);
+		Value = FMath::Min(Value, MaxValue);
 	}
 
-	OnValueIncreased.Broadcast(ResourceData.Value, Amount);
+	SetStoredValue(Value);
+	if(!bDeferred)
+	{
+		OnValueIncreased.Broadcast(Value, Amount);
+	}
 	return true;
 }
 
 bool UEntityResourceComponent::DecreaseMaxValue(int32 Amount, const bool bClampValue)
 {
-	if(Amount <= 0 || ResourceData.MaxValue <= 0)
+	int32 MaxValue = GetMaxValue();
+	if(Amount <= 0 || MaxValue <= 0)
 	{
 		return false;
 	}
 
-	ResourceData.MaxValue -= Amount;
-	ResourceData.MaxValue = FMath::Max(ResourceData.MaxValue, 0);
-	OnMaxValueDecreased.Broadcast(ResourceData.MaxValue, Amount);
+	const bool bDeferred = DeferNotification();
+	MaxValue -= Amount;
+	MaxValue = FMath::Max(MaxValue, 0);
+	SetStoredMaxValue(MaxValue);
+	if(!bDeferred)
+	{
+		OnMaxValueDecreased.Broadcast(MaxValue, Amount);
+	}
 
-	if(bClampValue && ResourceData.Value > ResourceData.MaxValue)
+	const int32 Value = GetValue();
+	if(bClampValue && Value > MaxValue)
 	{
-		Amount = ResourceData.Value - ResourceData.MaxValue;
+		Amount = Value - MaxValue;
 		DecreaseValue(Amount);
 	}
 
@@ -91,12 +135,18 @@ bool UEntityResourceComponent::IncreaseMaxValue(int32 Amount, const bool bClampV
 		return false;
 	}
 
-	ResourceData.MaxValue += Amount;
-	OnMaxValueIncreased.Broadcast(ResourceData.MaxValue, Amount);
+	const bool bDeferred = DeferNotification();
+	const int32 MaxValue = GetMaxValue() + Amount;
+	SetStoredMaxValue(MaxValue);
+	if(!bDeferred)
+	{
+		OnMaxValueIncreased.Broadcast(MaxValue, Amount);
+	}
 
-	if(bClampValue && ResourceData.Value < ResourceData.MaxValue)
+	const int32 Value = GetValue();
+	if(bClampValue && Value < MaxValue)
 	{
-		Amount = ResourceData.MaxValue - ResourceData.Value;
+		Amount = MaxValue - Value;
 		IncreaseValue(Amount, false);
 	}
 
@@ -105,18 +155,41 @@ bool UEntityResourceComponent::IncreaseMaxValue(int32 Amount, const bool bClampV
 
 int32 UEntityResourceComponent::GetValue() const
 {
-	return ResourceData.Value;
+	return ResourceSubsystem ? ResourceSubsystem->GetValue(ResourceHandle) : ResourceData.Value;
 }
 
 int32 UEntityResourceComponent::GetMaxValue() const
 {
-	return ResourceData.MaxValue;
+	return ResourceSubsystem ? ResourceSubsystem->GetMaxValue(ResourceHandle) : ResourceData.MaxValue;
+}
+
+void UEntityResourceComponent::SetRate(float Rate)
+{
+	ResourceData.Rate = Rate;
+	if(ResourceSubsystem)
+	{
+		ResourceSubsystem->SetRate(ResourceHandle, Rate);
+	}
+}
+
+float UEntityResourceComponent::GetRate() const
+{
+	return ResourceSubsystem ? ResourceSubsystem->GetRate(ResourceHandle) : ResourceData.Rate;
 }
 
 void UEntityResourceComponent::SetResourceData(const FResourceData& Data)
 {
+	const bool bDeferred = DeferNotification();
 	ResourceData = Data;
 	ResourceData.Value = ResourceData.bUseCustomInitialValue ? ResourceData.InitialValue : ResourceData.MaxValue;
+	SetStoredValue(ResourceData.Value);
+	SetStoredMaxValue(ResourceData.MaxValue);
+	SetRate(ResourceData.Rate);
+	if(bDeferred)
+	{
+		return;
+	}
+
 	OnValueIncreased.Broadcast(ResourceData.Value, 0);
 	OnMaxValueIncreased.Broadcast(ResourceData.MaxValue, 0);
 }
@@ -124,6 +197,145 @@ void UEntityResourceComponent::SetResourceData(const FResourceData& Data)
 void UEntityResourceComponent::GetResourceData(FResourceData& Data) const
 {
 	Data = ResourceData;
+	Data.Value = GetValue();
+	Data.MaxValue = GetMaxValue();
+}
+
+void UEntityResourceComponent::NotifyValueChanged(int32 AppliedAmount)
+{
+	const int32 Value = GetValue();
+	if(bBatchNotifications && ResourceSubsystem)
+	{
+		// the change is already applied, so the old value is taken from before it
+		if(!bNotificationPending)
+		{
+			bNotificationPending = true;
+			PendingOldValue = Value - AppliedAmount;
+			PendingOldMaxValue = GetMaxValue();
+			ResourceSubsystem->QueueNotification(this);
+		}
+		return;
+	}
+
+	if(AppliedAmount > 0)
+	{
+		OnValueIncreased.Broadcast(Value, AppliedAmount);
+		return;
+	}
+
+	OnValueDecreased.Broadcast(Value, -AppliedAmount);
+	if(Value == 0)
+	{
+		OnValueZero.Broadcast();
+	}
+}
+
+void UEntityResourceComponent::FlushNotifications()
+{
+	if(!bNotificationPending)
+	{
+		return;
+	}
+
+	bNotificationPending = false;
+
+	// one event per kind with the net change since the first change of the frame
+	BroadcastNetChange(PendingOldValue, PendingOldMaxValue);
+}
+
+void UEntityResourceComponent::ApplyReplicatedState(int32 Value, int32 MaxValue, float Rate, double RateStartTime)
+{
+	if(!ResourceSubsystem)
+	{
+		ResourceData.Value = Value;
+		ResourceData.MaxValue = MaxValue;
+		ResourceData.Rate = Rate;
+		return;
+	}
+
+	const bool bDeferred = DeferNotification();
+	const int32 OldValue = GetValue();
+	const int32 OldMaxValue = GetMaxValue();
+	ResourceData.Rate = Rate;
+	ResourceSubsystem->SetReplicatedState(ResourceHandle, Value, MaxValue, Rate, RateStartTime);
+	if(bDeferred)
+	{
+		return;
+	}
+
+	BroadcastNetChange(OldValue, OldMaxValue);
+}
+
+FEntityResourceHandle UEntityResourceComponent::GetResourceHandle() const
+{
+	return ResourceHandle;
+}
+
+bool UEntityResourceComponent::DeferNotification()
+{
+	// without the subsystem there is nothing to flush the notifications
+	if(!bBatchNotifications || !ResourceSubsystem)
+	{
+		return false;
+	}
+
+	if(!bNotificationPending)
+	{
+		bNotificationPending = true;
+		PendingOldValue = GetValue();
+		PendingOldMaxValue = GetMaxValue();
+		ResourceSubsystem->QueueNotification(this);
+	}
+	return true;
+}
+
+void UEntityResourceComponent::BroadcastNetChange(int32 OldValue, int32 OldMaxValue)
+{
+	const int32 MaxValue = GetMaxValue();
+	if(MaxValue < OldMaxValue)
+	{
+		OnMaxValueDecreased.Broadcast(MaxValue, OldMaxValue - MaxValue);
+	}
+	else if(MaxValue > OldMaxValue)
+	{
+		OnMaxValueIncreased.Broadcast(MaxValue, MaxValue - OldMaxValue);
+	}
+
+	const int32 Value = GetValue();
+	if(Value < OldValue)
+	{
+		OnValueDecreased.Broadcast(Value, OldValue - Value);
+		if(Value == 0)
+		{
+			OnValueZero.Broadcast();
+		}
+	}
+	else if(Value > OldValue)
+	{
+		OnValueIncreased.Broadcast(Value, Value - OldValue);
+	}
+}
+
+void UEntityResourceComponent::SetStoredValue(int32 Value)
+{
+	if(ResourceSubsystem)
+	{
+		ResourceSubsystem->SetValue(ResourceHandle, Value);
+		return;
+	}
+
+	ResourceData.Value = Value;
+}
+
+void UEntityResourceComponent::SetStoredMaxValue(int32 MaxValue)
+{
+	if(ResourceSubsystem)
+	{
+		ResourceSubsystem->SetMaxValue(ResourceHandle, MaxValue);
+		return;
+	}
+
+	ResourceData.MaxValue = MaxValue;
 }
 
 
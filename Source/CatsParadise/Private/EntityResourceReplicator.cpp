@@ -0,0 +1,153 @@
+#include "EntityResourceReplicator.h"
+
+#include "EntityResourceComponent.h"
+#include "EntityResourceSubsystem.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+
+void FEntityResourceReplicatedItem::PostReplicatedAdd(const FEntityResourceReplicatedArray& InArraySerializer)
+{
+	ApplyToComponent(InArraySerializer.Owner ? InArraySerializer.Owner->GetWorld() : nullptr);
+}
+
+void FEntityResourceReplicatedItem::PostReplicatedChange(const FEntityResourceReplicatedArray& InArraySerializer)
+{
+	ApplyToComponent(InArraySerializer.Owner ? InArraySerializer.Owner->GetWorld() : nullptr);
+}
+
+bool FEntityResourceReplicatedItem::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	constexpr float RateScale = UEntityResourceSubsystem::RateScale;
+
+	bOutSuccess = true;
+
+	UObject* ComponentObject = Component;
+	bOutSuccess &= Map->SerializeObject(Ar, UEntityResourceComponent::StaticClass(), ComponentObject);
+	Component = Cast<UEntityResourceComponent>(ComponentObject);
+
+	// resources are never negative, small values take a byte
+	uint32 PackedValue = static_cast<uint32>(FMath::Max(Value, 0));
+	uint32 PackedMaxValue = static_cast<uint32>(FMath::Max(MaxValue, 0));
+	Ar.SerializeIntPacked(PackedValue);
+	Ar.SerializeIntPacked(PackedMaxValue);
+	Value = static_cast<int32>(PackedValue);
+	MaxValue = static_cast<int32>(PackedMaxValue);
+
+	// the rate is zigzag encoded so small negative rates stay small, without a rate the start time isn't needed
+	const int32 QuantizedRate = FMath::RoundToInt32(Rate * RateScale);
+	uint32 PackedRate = (static_cast<uint32>(QuantizedRate) << 1) ^ static_cast<uint32>(QuantizedRate >> 31);
+	Ar.SerializeIntPacked(PackedRate);
+	const int32 ReceivedRate = static_cast<int32>(PackedRate >> 1) ^ -static_cast<int32>(PackedRate & 1);
+	Rate = ReceivedRate / RateScale;
+
+	if(ReceivedRate != 0)
+	{
+		// rounding the start would shift every predicted value of the rate
+		Ar << RateStartTime;
+	}
+
+	return true;
+}
+
+void FEntityResourceReplicatedItem::ApplyToComponent(const UWorld* World) const
+{
+	// the component may not be mapped yet, the change is applied again once it is or when it begins play
+	if(!World || !IsValid(Component) || !Component->HasBegunPlay())
+	{
+		return;
+	}
+
+	// the rate start is converted from server to local time, so regeneration is predicted from the same moment
+	const AGameStateBase* GameState = World->GetGameState();
+	const double ServerTimeOffset = GameState ? GameState->GetServerWorldTimeSeconds() - World->GetTimeSeconds() : 0.0;
+	Component->ApplyReplicatedState(Value, MaxValue, Rate, RateStartTime - ServerTimeOffset);
+}
+
+AEntityResourceReplicator::AEntityResourceReplicator()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	NetUpdateFrequency = 10.f;
+	ReplicatedResources.Owner = this;
+}
+
+void AEntityResourceReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AEntityResourceReplicator, ReplicatedResources);
+}
+
+void AEntityResourceReplicator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ReplicatedResources.Owner = this;
+	if(UEntityResourceSubsystem* ResourceSubsystem = UWorld::GetSubsystem<UEntityResourceSubsystem>(GetWorld()))
+	{
+		ResourceSubsystem->SetReplicator(this);
+	}
+}
+
+void AEntityResourceReplicator::AddResource(UEntityResourceComponent* Component, int32 Value, int32 MaxValue, float Rate, double RateStartTime)
+{
+	if(ItemIndices.Contains(Component))
+	{
+		UpdateResource(Component, Value, MaxValue, Rate, RateStartTime);
+		return;
+	}
+
+	FEntityResourceReplicatedItem& Item = ReplicatedResources.Items.AddDefaulted_GetRef();
+	Item.Component = Component;
+	SetItemState(Item, Value, MaxValue, Rate, RateStartTime);
+	ItemIndices.Add(Component, ReplicatedResources.Items.Num() - 1);
+	ReplicatedResources.MarkItemDirty(Item);
+}
+
+void AEntityResourceReplicator::UpdateResource(UEntityResourceComponent* Component, int32 Value, int32 MaxValue, float Rate, double RateStartTime)
+{
+	const int32* Index = ItemIndices.Find(Component);
+	if(!Index)
+	{
+		return;
+	}
+
+	FEntityResourceReplicatedItem& Item = ReplicatedResources.Items[*Index];
+	SetItemState(Item, Value, MaxValue, Rate, RateStartTime);
+	ReplicatedResources.MarkItemDirty(Item);
+}
+
+void AEntityResourceReplicator::RemoveResource(const UEntityResourceComponent* Component)
+{
+	int32 Index = INDEX_NONE;
+	if(!ItemIndices.RemoveAndCopyValue(Component, Index))
+	{
+		return;
+	}
+
+	// the last item takes the removed one's place
+	ReplicatedResources.Items.RemoveAtSwap(Index, 1, false);
+	if(ReplicatedResources.Items.IsValidIndex(Index))
+	{
+		ItemIndices.Add(ReplicatedResources.Items[Index].Component, Index);
+	}
+	ReplicatedResources.MarkArrayDirty();
+}
+
+void AEntityResourceReplicator::ApplyReceivedState(const UEntityResourceComponent* Component) const
+{
+	const FEntityResourceReplicatedItem* Item = ReplicatedResources.Items.FindByPredicate(
+		[Component](const FEntityResourceReplicatedItem& Other) { return Other.Component == Component; });
+	if(Item)
+	{
+		Item->ApplyToComponent(GetWorld());
+	}
+}
+
+void AEntityResourceReplicator::SetItemState(FEntityResourceReplicatedItem& Item, int32 Value, int32 MaxValue, float Rate, double RateStartTime)
+{
+	Item.Value = Value;
+	Item.MaxValue = MaxValue;
+	Item.Rate = Rate;
+	Item.RateStartTime = RateStartTime;
+}
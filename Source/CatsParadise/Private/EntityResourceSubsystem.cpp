@@ -0,0 +1,627 @@
+#include "EntityResourceSubsystem.h"
+#include "EntityResourceSubsystem.ispc.generated.h"
+
+#include "EntityResourceComponent.h"
+#include "EntityResourceReplicator.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Resource Radial Delta"), STAT_EntityResourceRadialDelta, STATGROUP_EntityResource);
+DECLARE_CYCLE_STAT(TEXT("Resource Delta To All"), STAT_EntityResourceDeltaToAll, STATGROUP_EntityResource);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resources"), STAT_EntityResources, STATGROUP_EntityResource);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resource Timers"), STAT_EntityResourceTimers, STATGROUP_EntityResource);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resource Notification Flushes"), STAT_EntityResourceFlushes, STATGROUP_EntityResource);
+
+static TAutoConsoleVariable<float> CVarResourceReplicationNearDistance(
+	TEXT("resource.ReplicationNearDistance"),
+	3000.f,
+	TEXT("Resources of actors within this distance in centimeters of a player are replicated at the near interval"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarResourceReplicationNearInterval(
+	TEXT("resource.ReplicationNearInterval"),
+	0.1f,
+	TEXT("Minimum seconds between two replicated changes of a resource near a player"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarResourceReplicationFarInterval(
+	TEXT("resource.ReplicationFarInterval"),
+	1.f,
+	TEXT("Minimum seconds between two replicated changes of a resource far from every player"),
+	ECVF_Default);
+
+void FEntityResourceTimingWheel::Add(FEntityResourceHandle Handle, uint32 Serial, double Time)
+{
+	if(Slots.IsEmpty())
+	{
+		Slots.SetNum(NumSlots);
+	}
+
+	// timers due in an elapsed tick go off on the next advance
+	FTimer Timer;
+	Timer.Handle = Handle;
+	Timer.Serial = Serial;
+	Timer.Tick = FMath::Max(FMath::FloorToInt64(Time / SlotDuration), CurrentTick + 1);
+	Slots[Timer.Tick % NumSlots].Add(Timer);
+}
+
+void FEntityResourceTimingWheel::Advance(double Time, TArray<FTimer>& OutExpired)
+{
+	const int64 TargetTick = FMath::FloorToInt64(Time / SlotDuration);
+	if(Slots.IsEmpty() || TargetTick <= CurrentTick)
+	{
+		CurrentTick = FMath::Max(CurrentTick, TargetTick);
+		return;
+	}
+
+	// a long hitch still visits every slot only once
+	const int64 FirstTick = FMath::Max(CurrentTick + 1, TargetTick - NumSlots + 1);
+	for(int64 Tick = FirstTick; Tick <= TargetTick; Tick++)
+	{
+		TArray<FTimer>& Slot = Slots[Tick % NumSlots];
+		for(int32 Index = Slot.Num() - 1; Index >= 0; Index--)
+		{
+			if(Slot[Index].Tick <= TargetTick)
+			{
+				OutExpired.Add(Slot[Index]);
+				Slot.RemoveAtSwap(Index, 1, false);
+			}
+		}
+	}
+
+	CurrentTick = TargetTick;
+}
+
+void FEntityResourceTimingWheel::Reset()
+{
+	Slots.Empty();
+	CurrentTick = -1;
+}
+
+void UEntityResourceSubsystem::Deinitialize()
+{
+	Slots.Empty();
+	FreeSlots.Empty();
+	Values.Empty();
+	MaxValues.Empty();
+	Rates.Empty();
+	RateStartTimes.Empty();
+	TimerSerials.Empty();
+	Components.Empty();
+	DenseToSlot.Empty();
+	TimingWheel.Reset();
+	PendingNotifications.Empty();
+	ReplicationDirty.Empty();
+	LastReplicationTimes.Empty();
+	NumReplicationDirty = 0;
+	PackedResources.Reset();
+
+	Super::Deinitialize();
+}
+
+void UEntityResourceSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// clients get the replicator from the server
+	const ENetMode NetMode = InWorld.GetNetMode();
+	if(NetMode == NM_Standalone || NetMode == NM_Client)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags |= RF_Transient;
+	SetReplicator(InWorld.SpawnActor<AEntityResourceReplicator>(SpawnParameters));
+}
+
+TStatId UEntityResourceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEntityResourceSubsystem, STATGROUP_Tickables);
+}
+
+void UEntityResourceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Time = GetTime();
+	ExpiredTimers.Reset();
+	TimingWheel.Advance(Time, ExpiredTimers);
+
+	TArray<TPair<TWeakObjectPtr<UEntityResourceComponent>, int32>> Changes;
+	for(const FEntityResourceTimingWheel::FTimer& Timer : ExpiredTimers)
+	{
+		const int32 DenseIndex = FindDenseIndex(Timer.Handle);
+		if(DenseIndex == INDEX_NONE || TimerSerials[DenseIndex] != Timer.Serial)
+		{
+			continue;
+		}
+
+		INC_DWORD_STAT(STAT_EntityResourceTimers);
+
+		const int32 Applied = RebaseValue(DenseIndex, Time);
+		const bool bReachedBoundary = Rates[DenseIndex] > 0.f ? Values[DenseIndex] >= MaxValues[DenseIndex] : Values[DenseIndex] <= 0;
+		if(!bReachedBoundary)
+		{
+			// the timer rounded down, try again a little later
+			ScheduleBoundary(DenseIndex);
+		}
+
+		if(Applied != 0)
+		{
+			Changes.Emplace(Components[DenseIndex], Applied);
+		}
+	}
+
+	NotifyChanges(Changes);
+
+	if(NumReplicationDirty > 0)
+	{
+		ReplicateDirtyResources(Time);
+	}
+
+	// after the timers, so their changes are flushed this frame too, listeners queueing more go to the next one
+	if(!PendingNotifications.IsEmpty())
+	{
+		TArray<TWeakObjectPtr<UEntityResourceComponent>> Notifications = MoveTemp(PendingNotifications);
+		for(const TWeakObjectPtr<UEntityResourceComponent>& Component : Notifications)
+		{
+			if(Component.IsValid())
+			{
+				INC_DWORD_STAT(STAT_EntityResourceFlushes);
+				Component->FlushNotifications();
+			}
+		}
+	}
+}
+
+FEntityResourceHandle UEntityResourceSubsystem::AddResource(UEntityResourceComponent* Component, int32 Value, int32 MaxValue)
+{
+	const int32 Slot = FreeSlots.IsEmpty() ? Slots.AddDefaulted() : FreeSlots.Pop(false);
+
+	const int32 DenseIndex = Values.Add(Value);
+	MaxValues.Add(MaxValue);
+	Rates.Add(0.f);
+	RateStartTimes.Add(GetTime());
+	TimerSerials.Add(0);
+	Components.Add(Component);
+	DenseToSlot.Add(Slot);
+	ReplicationDirty.Add(false);
+	LastReplicationTimes.Add(GetTime());
+
+	Slots[Slot].DenseIndex = DenseIndex;
+	SET_DWORD_STAT(STAT_EntityResources, Values.Num());
+
+	if(ShouldReplicate(DenseIndex))
+	{
+		Replicator->AddResource(Component, Value, MaxValue, 0.f, RateStartTimes[DenseIndex]);
+	}
+
+	FEntityResourceHandle Handle;
+	Handle.Slot = Slot;
+	Handle.Generation = Slots[Slot].Generation;
+	return Handle;
+}
+
+void UEntityResourceSubsystem::RemoveResource(FEntityResourceHandle Handle)
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	if(DenseIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if(ShouldReplicate(DenseIndex))
+	{
+		Replicator->RemoveResource(Components[DenseIndex].Get());
+	}
+	if(ReplicationDirty[DenseIndex])
+	{
+		NumReplicationDirty--;
+	}
+
+	// the last resource takes the removed one's place
+	const int32 LastSlot = DenseToSlot.Last();
+	Slots[LastSlot].DenseIndex = DenseIndex;
+
+	Values.RemoveAtSwap(DenseIndex, 1, false);
+	MaxValues.RemoveAtSwap(DenseIndex, 1, false);
+	Rates.RemoveAtSwap(DenseIndex, 1, false);
+	RateStartTimes.RemoveAtSwap(DenseIndex, 1, false);
+	TimerSerials.RemoveAtSwap(DenseIndex, 1, false);
+	Components.RemoveAtSwap(DenseIndex, 1, false);
+	DenseToSlot.RemoveAtSwap(DenseIndex, 1, false);
+	ReplicationDirty.RemoveAtSwap(DenseIndex, 1, false);
+	LastReplicationTimes.RemoveAtSwap(DenseIndex, 1, false);
+
+	// bumping the generation makes every handle to the slot stale
+	Slots[Handle.Slot].DenseIndex = INDEX_NONE;
+	Slots[Handle.Slot].Generation++;
+	FreeSlots.Add(Handle.Slot);
+	SET_DWORD_STAT(STAT_EntityResources, Values.Num());
+}
+
+bool UEntityResourceSubsystem::IsValidHandle(FEntityResourceHandle Handle) const
+{
+	return FindDenseIndex(Handle) != INDEX_NONE;
+}
+
+int32 UEntityResourceSubsystem::GetValue(FEntityResourceHandle Handle) const
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	return DenseIndex != INDEX_NONE ? EvaluateValue(DenseIndex, GetTime()) : 0;
+}
+
+int32 UEntityResourceSubsystem::GetMaxValue(FEntityResourceHandle Handle) const
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	return DenseIndex != INDEX_NONE ? MaxValues[DenseIndex] : 0;
+}
+
+void UEntityResourceSubsystem::SetValue(FEntityResourceHandle Handle, int32 Value)
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	if(DenseIndex != INDEX_NONE)
+	{
+		Values[DenseIndex] = Value;
+		RateStartTimes[DenseIndex] = GetTime();
+		ScheduleBoundary(DenseIndex);
+		MarkReplicationDirty(DenseIndex);
+	}
+}
+
+void UEntityResourceSubsystem::SetMaxValue(FEntityResourceHandle Handle, int32 MaxValue)
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	if(DenseIndex != INDEX_NONE)
+	{
+		RebaseValue(DenseIndex, GetTime());
+		MaxValues[DenseIndex] = MaxValue;
+		ScheduleBoundary(DenseIndex);
+		MarkReplicationDirty(DenseIndex);
+	}
+}
+
+float UEntityResourceSubsystem::GetRate(FEntityResourceHandle Handle) const
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	return DenseIndex != INDEX_NONE ? Rates[DenseIndex] : 0.f;
+}
+
+float UEntityResourceSubsystem::QuantizeRate(float Rate)
+{
+	return FMath::RoundToInt32(Rate * RateScale) / RateScale;
+}
+
+void UEntityResourceSubsystem::SetRate(FEntityResourceHandle Handle, float Rate)
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	if(DenseIndex != INDEX_NONE)
+	{
+		RebaseValue(DenseIndex, GetTime());
+		// clients predict with the replicated rate, so the server has to use the same one
+		Rates[DenseIndex] = QuantizeRate(Rate);
+		ScheduleBoundary(DenseIndex);
+		MarkReplicationDirty(DenseIndex);
+	}
+}
+
+int32 UEntityResourceSubsystem::ApplyRadialDelta(const FVector& Center, float Radius, int32 Delta)
+{
+	if(Delta == 0 || Radius <= 0.f || Values.IsEmpty())
+	{
+		return 0;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_EntityResourceRadialDelta);
+
+	RebaseAllValues(GetTime());
+
+	// owner locations relative to the center keep float precision far from the origin,
+	// resources without an owner are pushed out of any radius
+	const int32 NumResources = Values.Num();
+	RelativeX.SetNumUninitialized(NumResources);
+	RelativeY.SetNumUninitialized(NumResources);
+	RelativeZ.SetNumUninitialized(NumResources);
+	for(int32 Index = 0; Index < NumResources; Index++)
+	{
+		const UEntityResourceComponent* Component = Components[Index].Get();
+		const AActor* Owner = Component ? Component->GetOwner() : nullptr;
+		const FVector Relative = Owner ? Owner->GetActorLocation() - Center : FVector(UE_BIG_NUMBER);
+		RelativeX[Index] = static_cast<float>(Relative.X);
+		RelativeY[Index] = static_cast<float>(Relative.Y);
+		RelativeZ[Index] = static_cast<float>(Relative.Z);
+	}
+
+	AppliedDeltas.SetNumUninitialized(NumResources);
+	ispc::FEntityResource_ApplyRadialDelta(
+		RelativeX.GetData(),
+		RelativeY.GetData(),
+		RelativeZ.GetData(),
+		FMath::Square(Radius),
+		Delta,
+		Values.GetData(),
+		MaxValues.GetData(),
+		AppliedDeltas.GetData(),
+		NumResources);
+
+	return NotifyAppliedDeltas();
+}
+
+int32 UEntityResourceSubsystem::ApplyDeltaToAll(int32 Delta)
+{
+	if(Delta == 0 || Values.IsEmpty())
+	{
+		return 0;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_EntityResourceDeltaToAll);
+
+	RebaseAllValues(GetTime());
+
+	AppliedDeltas.SetNumUninitialized(Values.Num());
+	ispc::FEntityResource_ApplyDelta(
+		Delta,
+		Values.GetData(),
+		MaxValues.GetData(),
+		AppliedDeltas.GetData(),
+		Values.Num());
+
+	return NotifyAppliedDeltas();
+}
+
+int32 UEntityResourceSubsystem::GetNumResources() const
+{
+	return Values.Num();
+}
+
+void UEntityResourceSubsystem::QueueNotification(UEntityResourceComponent* Component)
+{
+	PendingNotifications.Add(Component);
+}
+
+void UEntityResourceSubsystem::SetReplicator(AEntityResourceReplicator* InReplicator)
+{
+	Replicator = InReplicator;
+
+	if(!InReplicator || !InReplicator->HasAuthority())
+	{
+		return;
+	}
+
+	for(int32 Index = 0; Index < Values.Num(); Index++)
+	{
+		if(ShouldReplicate(Index))
+		{
+			InReplicator->AddResource(Components[Index].Get(), Values[Index], MaxValues[Index], Rates[Index], RateStartTimes[Index]);
+		}
+	}
+}
+
+void UEntityResourceSubsystem::SetReplicatedState(FEntityResourceHandle Handle, int32 Value, int32 MaxValue, float Rate, double RateStartTime)
+{
+	const int32 DenseIndex = FindDenseIndex(Handle);
+	if(DenseIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	Values[DenseIndex] = Value;
+	MaxValues[DenseIndex] = MaxValue;
+	Rates[DenseIndex] = QuantizeRate(Rate);
+	RateStartTimes[DenseIndex] = RateStartTime;
+	ScheduleBoundary(DenseIndex);
+}
+
+void UEntityResourceSubsystem::ApplyReceivedState(const UEntityResourceComponent* Component) const
+{
+	const AEntityResourceReplicator* ReplicatorActor = Replicator.Get();
+	if(ReplicatorActor && !ReplicatorActor->HasAuthority())
+	{
+		ReplicatorActor->ApplyReceivedState(Component);
+	}
+}
+
+FPackedEntityResources& UEntityResourceSubsystem::GetPackedResources()
+{
+	return PackedResources;
+}
+
+int32 UEntityResourceSubsystem::FindDenseIndex(FEntityResourceHandle Handle) const
+{
+	if(!Slots.IsValidIndex(Handle.Slot) || Slots[Handle.Slot].Generation != Handle.Generation)
+	{
+		return INDEX_NONE;
+	}
+
+	return Slots[Handle.Slot].DenseIndex;
+}
+
+bool UEntityResourceSubsystem::ShouldReplicate(int32 DenseIndex) const
+{
+	if(!Replicator.IsValid() || !Replicator->HasAuthority())
+	{
+		return false;
+	}
+
+	// the component has to be reachable on clients
+	const UEntityResourceComponent* Component = Components[DenseIndex].Get();
+	return Component && Component->GetOwner() && Component->GetOwner()->GetIsReplicated();
+}
+
+void UEntityResourceSubsystem::MarkReplicationDirty(int32 DenseIndex)
+{
+	if(!ReplicationDirty[DenseIndex] && ShouldReplicate(DenseIndex))
+	{
+		ReplicationDirty[DenseIndex] = true;
+		NumReplicationDirty++;
+	}
+}
+
+void UEntityResourceSubsystem::ReplicateDirtyResources(double Time)
+{
+	AEntityResourceReplicator* ReplicatorActor = Replicator.Get();
+	if(!ReplicatorActor)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<8>> PlayerLocations;
+	for(FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if(const APawn* Pawn = It->IsValid() ? (*It)->GetPawn() : nullptr)
+		{
+			PlayerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	const float NearDistanceSquared = FMath::Square(CVarResourceReplicationNearDistance.GetValueOnGameThread());
+	const float NearInterval = CVarResourceReplicationNearInterval.GetValueOnGameThread();
+	const float FarInterval = CVarResourceReplicationFarInterval.GetValueOnGameThread();
+
+	for(int32 Index = 0; Index < Values.Num() && NumReplicationDirty > 0; Index++)
+	{
+		if(!ReplicationDirty[Index])
+		{
+			continue;
+		}
+
+		const double Elapsed = Time - LastReplicationTimes[Index];
+		if(Elapsed < NearInterval)
+		{
+			continue;
+		}
+
+		UEntityResourceComponent* Component = Components[Index].Get();
+		if(Elapsed < FarInterval && Component && Component->GetOwner())
+		{
+			const FVector Location = Component->GetOwner()->GetActorLocation();
+			const bool bNearPlayer = PlayerLocations.ContainsByPredicate(
+				[&](const FVector& PlayerLocation) { return FVector::DistSquared(PlayerLocation, Location) <= NearDistanceSquared; });
+			if(!bNearPlayer)
+			{
+				continue;
+			}
+		}
+
+		ReplicationDirty[Index] = false;
+		NumReplicationDirty--;
+		LastReplicationTimes[Index] = Time;
+		ReplicatorActor->UpdateResource(Component, Values[Index], MaxValues[Index], Rates[Index], RateStartTimes[Index]);
+	}
+}
+
+FEntityResourceHandle UEntityResourceSubsystem::MakeHandle(int32 DenseIndex) const
+{
+	FEntityResourceHandle Handle;
+	Handle.Slot = DenseToSlot[DenseIndex];
+	Handle.Generation = Slots[Handle.Slot].Generation;
+	return Handle;
+}
+
+double UEntityResourceSubsystem::GetTime() const
+{
+	return GetWorld()->GetTimeSeconds();
+}
+
+int32 UEntityResourceSubsystem::EvaluateValue(int32 DenseIndex, double Time) const
+{
+	const int32 Value = Values[DenseIndex];
+	const float Rate = Rates[DenseIndex];
+	if(Rate == 0.f)
+	{
+		return Value;
+	}
+
+	// whole points only, a value over the max isn't pulled down by regeneration
+	const int64 Delta = static_cast<int64>(Rate * (Time - RateStartTimes[DenseIndex]));
+	return static_cast<int32>(FMath::Clamp<int64>(Value + Delta, 0, FMath::Max(MaxValues[DenseIndex], Value)));
+}
+
+int32 UEntityResourceSubsystem::RebaseValue(int32 DenseIndex, double Time)
+{
+	const int32 Value = EvaluateValue(DenseIndex, Time);
+	const int32 Applied = Value - Values[DenseIndex];
+	if(Applied == 0)
+	{
+		return 0;
+	}
+
+	// the start only moves by the whole points applied so the fraction of the next one isn't lost,
+	// unless the value stopped at a boundary
+	const bool bAtBoundary = Value <= 0 || Value >= MaxValues[DenseIndex];
+	RateStartTimes[DenseIndex] = bAtBoundary ? Time : RateStartTimes[DenseIndex] + Applied / Rates[DenseIndex];
+	Values[DenseIndex] = Value;
+	return Applied;
+}
+
+void UEntityResourceSubsystem::RebaseAllValues(double Time)
+{
+	for(int32 Index = 0; Index < Values.Num(); Index++)
+	{
+		if(Rates[Index] != 0.f)
+		{
+			RebaseValue(Index, Time);
+		}
+	}
+}
+
+void UEntityResourceSubsystem::ScheduleBoundary(int32 DenseIndex)
+{
+	const uint32 Serial = ++TimerSerials[DenseIndex];
+
+	const float Rate = Rates[DenseIndex];
+	const int32 Value = Values[DenseIndex];
+	int32 Distance = 0;
+	if(Rate > 0.f)
+	{
+		Distance = MaxValues[DenseIndex] - Value;
+	}
+	else if(Rate < 0.f)
+	{
+		Distance = Value;
+	}
+
+	if(Distance <= 0)
+	{
+		return;
+	}
+
+	TimingWheel.Add(MakeHandle(DenseIndex), Serial, RateStartTimes[DenseIndex] + Distance / FMath::Abs(Rate));
+}
+
+int32 UEntityResourceSubsystem::NotifyAppliedDeltas()
+{
+	// listeners may remove resources, which reorders the dense arrays, so the changes are collected first
+	TArray<TPair<TWeakObjectPtr<UEntityResourceComponent>, int32>> Changes;
+	for(int32 Index = 0; Index < AppliedDeltas.Num(); Index++)
+	{
+		if(AppliedDeltas[Index] != 0)
+		{
+			Changes.Emplace(Components[Index], AppliedDeltas[Index]);
+			MarkReplicationDirty(Index);
+
+			// the pass moved the value, so the boundary of a regenerating or decaying resource moved too
+			if(Rates[Index] != 0.f)
+			{
+				ScheduleBoundary(Index);
+			}
+		}
+	}
+
+	NotifyChanges(Changes);
+	return Changes.Num();
+}
+
+void UEntityResourceSubsystem::NotifyChanges(const TArray<TPair<TWeakObjectPtr<UEntityResourceComponent>, int32>>& Changes)
+{
+	for(const TPair<TWeakObjectPtr<UEntityResourceComponent>, int32>& Change : Changes)
+	{
+		if(UEntityResourceComponent* Component = Change.Key.Get())
+		{
+			Component->NotifyValueChanged(Change.Value);
+		}
+	}
+}
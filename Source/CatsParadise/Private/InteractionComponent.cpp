@@ -1,8 +1,10 @@
 #include "InteractionComponent.h"
 
+#include "InteractionGridSubsystem.h"
+
 UInteractionComponent::UInteractionComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
 
 	UPrimitiveComponent::SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	UPrimitiveComponent::SetCollisionObjectType(ECC_WorldDynamic);
@@ -15,15 +17,46 @@ void UInteractionComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if(Discovery == EInteractionDiscovery::SpatialHash)
+	{
+		if(UInteractionGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UInteractionGridSubsystem>(GetWorld()))
+		{
+			// keep blocking visibility for sight traces, only the pawn overlaps are replaced by the grid
+			SetCollisionResponseToChannel(ECC_Pawn, ECR_Ignore);
+			SetGenerateOverlapEvents(false);
+			GridSubsystem->RegisterInteractable(this);
+			return;
+		}
+	}
+
 	OnComponentBeginOverlap.AddDynamic(this, &UInteractionComponent::HandleBeginOverlap);
 	OnComponentEndOverlap.AddDynamic(this, &UInteractionComponent::HandleEndOverlap);
 }
 
+void UInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(Discovery == EInteractionDiscovery::SpatialHash)
+	{
+		if(UInteractionGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UInteractionGridSubsystem>(GetWorld()))
+		{
+			GridSubsystem->UnregisterInteractable(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
-void UInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UInteractionComponent::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
 
+	if(Discovery == EInteractionDiscovery::SpatialHash && HasBegunPlay())
+	{
+		if(UInteractionGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UInteractionGridSubsystem>(GetWorld()))
+		{
+			GridSubsystem->UpdateInteractable(this);
+		}
+	}
 }
 
 void UInteractionComponent::SetInteractionMessage(AActor* Actor, const FString& Message)
@@ -159,6 +192,33 @@ void UInteractionComponent::HandleEndOverlap(UPrimitiveComponent* OverlappedComp
 	EndOverlap(OtherActor);
 }
 
+void UInteractionComponent::SetDormant(bool bNewDormant)
+{
+	if(bDormant == bNewDormant)
+	{
+		return;
+	}
+
+	bDormant = bNewDormant;
+
+	if(bDormant)
+	{
+		AwakeCollisionEnabled = GetCollisionEnabled();
+		SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+	else
+	{
+		SetCollisionEnabled(AwakeCollisionEnabled);
+	}
+
+	OnDormancyChanged.Broadcast(bDormant);
+}
+
+bool UInteractionComponent::IsDormant() const
+{
+	return bDormant;
+}
+
 void UInteractionComponent::SetTriggerDefaultCollision(UShapeComponent* ShapeComponent)
 {
 	if (!ShapeComponent)
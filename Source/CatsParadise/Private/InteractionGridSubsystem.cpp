@@ -0,0 +1,409 @@
+#include "InteractionGridSubsystem.h"
+
+#include "InteractionComponent.h"
+#include "PlayerFocusSubsystem.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Interaction Grid Tick"), STAT_InteractionGridTick, STATGROUP_Interaction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Grid Queries"), STAT_InteractionGridQueries, STATGROUP_Interaction);
+
+static TAutoConsoleVariable<float> CVarInteractionGridCellSize(
+	TEXT("interaction.GridCellSize"),
+	500.f,
+	TEXT("Cell size in centimeters of the spatial hash interactables are discovered from. Only read when the world starts"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarInteractionGridQueryDistance(
+	TEXT("interaction.GridQueryDistance"),
+	10.f,
+	TEXT("How far in centimeters an actor with an interaction queue moves before it looks for interactables again"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarInteractionGridWakeDistance(
+	TEXT("interaction.GridWakeDistance"),
+	2000.f,
+	TEXT("Interactables farther than this in centimeters from every actor with an interaction queue are dormant"),
+	ECVF_Default);
+
+namespace InteractionGridLocal
+{
+	/** Calls Entered for the ids only in NewIds and Left for the ids only in OldIds, both sorted. */
+	template<typename EnteredFunc, typename LeftFunc>
+	void DiffSortedIds(const TArray<int32>& OldIds, const TArray<int32>& NewIds, EnteredFunc Entered, LeftFunc Left)
+	{
+		int32 OldIndex = 0;
+		int32 NewIndex = 0;
+		while(OldIndex < OldIds.Num() || NewIndex < NewIds.Num())
+		{
+			if(NewIndex >= NewIds.Num() || (OldIndex < OldIds.Num() && OldIds[OldIndex] < NewIds[NewIndex]))
+			{
+				Left(OldIds[OldIndex++]);
+			}
+			else if(OldIndex >= OldIds.Num() || NewIds[NewIndex] < OldIds[OldIndex])
+			{
+				Entered(NewIds[NewIndex++]);
+			}
+			else
+			{
+				OldIndex++;
+				NewIndex++;
+			}
+		}
+	}
+}
+
+void UInteractionGridSubsystem::Deinitialize()
+{
+	Interactables.Empty();
+	InteractableIds.Empty();
+	Cells.Empty();
+	Seekers.Empty();
+	DirtyCells.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UInteractionGridSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionGridSubsystem, STATGROUP_Tickables);
+}
+
+void UInteractionGridSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if(Seekers.IsEmpty() || Interactables.IsEmpty())
+	{
+		DirtyCells.Reset();
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionGridTick);
+
+	const float QueryDistanceSquared = FMath::Square(CVarInteractionGridQueryDistance.GetValueOnGameThread());
+	TArray<int32> NewInside;
+	TArray<int32> NewNearby;
+	// overlap callbacks may change interactables, those changes are left for the next tick
+	const int32 NumDirtyCells = DirtyCells.Num();
+
+	for(int32 Index = Seekers.Num() - 1; Index >= 0; Index--)
+	{
+		FSeekerEntry& Seeker = Seekers[Index];
+		const AActor* SeekerActor = Seeker.Actor.Get();
+		if(!SeekerActor)
+		{
+			// let the interactables around it fall asleep
+			UpdateSeeker(Seeker, TArray<int32>(), TArray<int32>());
+			Seekers.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if(!NeedsQuery(Seeker, QueryDistanceSquared))
+		{
+			continue;
+		}
+
+		QuerySeeker(Seeker, NewInside, NewNearby);
+		UpdateSeeker(Seeker, NewInside, NewNearby);
+	}
+
+	DirtyCells.RemoveAt(0, NumDirtyCells);
+}
+
+void UInteractionGridSubsystem::RegisterInteractable(UInteractionComponent* Interactable)
+{
+	if(!IsValid(Interactable) || InteractableIds.Contains(Interactable))
+	{
+		return;
+	}
+
+	FInteractableEntry Entry;
+	Entry.Component = Interactable;
+	Entry.Location = Interactable->GetComponentLocation();
+	Entry.Radius = Interactable->GetScaledSphereRadius();
+	Entry.Cell = GetCell(Entry.Location);
+
+	const int32 Id = Interactables.Add(Entry);
+	InteractableIds.Add(Interactable, Id);
+	AddToCell(Id, Entry.Cell);
+
+	MaxInteractableRadius = FMath::Max(MaxInteractableRadius, Entry.Radius);
+	MarkCellDirty(Entry.Cell);
+
+	// dormant until a seeker comes near
+	Interactable->SetDormant(true);
+}
+
+void UInteractionGridSubsystem::UnregisterInteractable(UInteractionComponent* Interactable)
+{
+	int32 Id = INDEX_NONE;
+	if(!InteractableIds.RemoveAndCopyValue(Interactable, Id))
+	{
+		return;
+	}
+
+	MarkCellDirty(Interactables[Id].Cell);
+	RemoveFromCell(Id, Interactables[Id].Cell);
+	Interactables.RemoveAt(Id);
+
+	// seekers inside it leave it now, its id may be reused by the next interactable
+	for(FSeekerEntry& Seeker : Seekers)
+	{
+		Seeker.Nearby.RemoveSingle(Id);
+		if(Seeker.Inside.RemoveSingle(Id) > 0 && IsValid(Interactable))
+		{
+			Interactable->EndOverlap(Seeker.Actor.Get());
+		}
+	}
+
+	if(IsValid(Interactable))
+	{
+		Interactable->SetDormant(false);
+	}
+}
+
+void UInteractionGridSubsystem::UpdateInteractable(UInteractionComponent* Interactable)
+{
+	const int32* Id = InteractableIds.Find(Interactable);
+	if(!Id)
+	{
+		return;
+	}
+
+	FInteractableEntry& Entry = Interactables[*Id];
+	const FVector Location = Interactable->GetComponentLocation();
+	const float Radius = Interactable->GetScaledSphereRadius();
+	// small moves like bobbing on the waves aren't worth making every seeker query again
+	const float QueryDistanceSquared = FMath::Square(CVarInteractionGridQueryDistance.GetValueOnGameThread());
+	if(FVector::DistSquared(Location, Entry.Location) <= QueryDistanceSquared && Radius == Entry.Radius)
+	{
+		return;
+	}
+
+	// only the seekers around the old and the new cell query again
+	const FIntPoint Cell = GetCell(Location);
+	MarkCellDirty(Entry.Cell);
+	if(Cell != Entry.Cell)
+	{
+		RemoveFromCell(*Id, Entry.Cell);
+		AddToCell(*Id, Cell);
+		MarkCellDirty(Cell);
+		Entry.Cell = Cell;
+	}
+
+	Entry.Location = Location;
+	Entry.Radius = Radius;
+	MaxInteractableRadius = FMath::Max(MaxInteractableRadius, Radius);
+}
+
+void UInteractionGridSubsystem::RefreshInteractable(UInteractionComponent* Interactable)
+{
+	if(const int32* Id = InteractableIds.Find(Interactable))
+	{
+		MarkCellDirty(Interactables[*Id].Cell);
+	}
+}
+
+void UInteractionGridSubsystem::RegisterSeeker(AActor* Seeker)
+{
+	if(!IsValid(Seeker) || Seekers.ContainsByPredicate([&](const FSeekerEntry& Entry) { return Entry.Actor == Seeker; }))
+	{
+		return;
+	}
+
+	FSeekerEntry& Entry = Seekers.AddDefaulted_GetRef();
+	Entry.Actor = Seeker;
+}
+
+void UInteractionGridSubsystem::UnregisterSeeker(AActor* Seeker)
+{
+	const int32 Index = Seekers.IndexOfByPredicate([&](const FSeekerEntry& Entry) { return Entry.Actor == Seeker; });
+	if(Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	// leave everything so the queue doesn't keep stale entries
+	UpdateSeeker(Seekers[Index], TArray<int32>(), TArray<int32>());
+	Seekers.RemoveAtSwap(Index);
+}
+
+FIntPoint UInteractionGridSubsystem::GetCell(const FVector& Location) const
+{
+	const float CellSize = FMath::Max(CVarInteractionGridCellSize.GetValueOnGameThread(), 1.f);
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UInteractionGridSubsystem::MarkCellDirty(const FIntPoint& Cell)
+{
+	DirtyCells.AddUnique(Cell);
+}
+
+bool UInteractionGridSubsystem::NeedsQuery(const FSeekerEntry& Seeker, float QueryDistanceSquared) const
+{
+	const AActor* SeekerActor = Seeker.Actor.Get();
+	if(!Seeker.bQueried || FVector::DistSquared(Seeker.QueryLocation, SeekerActor->GetActorLocation()) > QueryDistanceSquared)
+	{
+		return true;
+	}
+
+	// a larger interactable than any before may reach the seeker from outside the queried cells
+	if(GetQueryRange(SeekerActor->GetSimpleCollisionRadius()) > Seeker.QueryRange)
+	{
+		return true;
+	}
+
+	return DirtyCells.ContainsByPredicate([&](const FIntPoint& Cell)
+	{
+		return Cell.X >= Seeker.QueryMinCell.X && Cell.X <= Seeker.QueryMaxCell.X
+			&& Cell.Y >= Seeker.QueryMinCell.Y && Cell.Y <= Seeker.QueryMaxCell.Y;
+	});
+}
+
+float UInteractionGridSubsystem::GetQueryRange(float SeekerRadius) const
+{
+	return FMath::Max(MaxInteractableRadius + SeekerRadius, CVarInteractionGridWakeDistance.GetValueOnGameThread());
+}
+
+void UInteractionGridSubsystem::AddToCell(int32 Id, const FIntPoint& Cell)
+{
+	Cells.FindOrAdd(Cell).Add(Id);
+}
+
+void UInteractionGridSubsystem::RemoveFromCell(int32 Id, const FIntPoint& Cell)
+{
+	if(TArray<int32>* CellIds = Cells.Find(Cell))
+	{
+		CellIds->RemoveSingleSwap(Id);
+		if(CellIds->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UInteractionGridSubsystem::QuerySeeker(FSeekerEntry& Seeker, TArray<int32>& OutInside, TArray<int32>& OutNearby) const
+{
+	INC_DWORD_STAT(STAT_InteractionGridQueries);
+
+	const AActor* SeekerActor = Seeker.Actor.Get();
+	const FVector Location = SeekerActor->GetActorLocation();
+	// the overlaps used to be against the pawn capsule, so interactables on the floor at its feet are inside too
+	float SeekerRadius = 0.f;
+	float SeekerHalfHeight = 0.f;
+	SeekerActor->GetSimpleCollisionCylinder(SeekerRadius, SeekerHalfHeight);
+	const float SegmentHalfHeight = FMath::Max(SeekerHalfHeight - SeekerRadius, 0.f);
+	const float WakeDistanceSquared = FMath::Square(CVarInteractionGridWakeDistance.GetValueOnGameThread());
+	const float Range = GetQueryRange(SeekerRadius);
+	const FIntPoint MinCell = GetCell(Location - FVector(Range));
+	const FIntPoint MaxCell = GetCell(Location + FVector(Range));
+
+	Seeker.QueryLocation = Location;
+	Seeker.QueryMinCell = MinCell;
+	Seeker.QueryMaxCell = MaxCell;
+	Seeker.QueryRange = Range;
+	Seeker.bQueried = true;
+
+	OutInside.Reset();
+	OutNearby.Reset();
+
+	for(int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+	{
+		for(int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			const TArray<int32>* CellIds = Cells.Find(FIntPoint(X, Y));
+			if(!CellIds)
+			{
+				continue;
+			}
+
+			for(const int32 Id : *CellIds)
+			{
+				const FInteractableEntry& Entry = Interactables[Id];
+				const UInteractionComponent* Component = Entry.Component.Get();
+				if(!Component || !Component->GetOwner() || Component->GetOwner() == SeekerActor)
+				{
+					continue;
+				}
+
+				// the sphere against the capsule is the sphere against the segment between the capsule's hemispheres
+				const FVector SegmentPoint(Location.X, Location.Y,
+					FMath::Clamp(Entry.Location.Z, Location.Z - SegmentHalfHeight, Location.Z + SegmentHalfHeight));
+				const bool bInside = FVector::DistSquared(SegmentPoint, Entry.Location) <= FMath::Square(Entry.Radius + SeekerRadius);
+				const float DistanceSquared = FVector::DistSquared(Location, Entry.Location);
+				if(bInside || DistanceSquared <= WakeDistanceSquared)
+				{
+					OutNearby.Add(Id);
+				}
+
+				// disabled pickups turn their collision off, which used to stop the overlaps as well
+				if(bInside && Component->GetOwner()->GetActorEnableCollision())
+				{
+					OutInside.Add(Id);
+				}
+			}
+		}
+	}
+
+	OutInside.Sort();
+	OutNearby.Sort();
+}
+
+void UInteractionGridSubsystem::UpdateSeeker(FSeekerEntry& Seeker, const TArray<int32>& NewInside, const TArray<int32>& NewNearby)
+{
+	AActor* SeekerActor = Seeker.Actor.Get();
+	const TArray<int32> OldInside = MoveTemp(Seeker.Inside);
+	const TArray<int32> OldNearby = MoveTemp(Seeker.Nearby);
+	Seeker.Inside = NewInside;
+	Seeker.Nearby = NewNearby;
+
+	// the callbacks may destroy interactables, so ids are checked again on every step
+	auto GetInteractable = [this](int32 Id) -> UInteractionComponent*
+	{
+		return Interactables.IsValidIndex(Id) ? Interactables[Id].Component.Get() : nullptr;
+	};
+
+	// wake first, so interactables are awake by the time the seeker overlaps them
+	InteractionGridLocal::DiffSortedIds(OldNearby, NewNearby,
+		[&](int32 Id)
+		{
+			if(Interactables.IsValidIndex(Id) && Interactables[Id].NumNearbySeekers++ == 0)
+			{
+				if(UInteractionComponent* Component = GetInteractable(Id))
+				{
+					Component->SetDormant(false);
+				}
+			}
+		},
+		[&](int32 Id)
+		{
+			if(Interactables.IsValidIndex(Id) && --Interactables[Id].NumNearbySeekers == 0)
+			{
+				if(UInteractionComponent* Component = GetInteractable(Id))
+				{
+					Component->SetDormant(true);
+				}
+			}
+		});
+
+	if(!SeekerActor)
+	{
+		return;
+	}
+
+	InteractionGridLocal::DiffSortedIds(OldInside, NewInside,
+		[&](int32 Id)
+		{
+			if(UInteractionComponent* Component = GetInteractable(Id))
+			{
+				Component->BeginOverlap(SeekerActor);
+			}
+		},
+		[&](int32 Id)
+		{
+			if(UInteractionComponent* Component = GetInteractable(Id))
+			{
+				Component->EndOverlap(SeekerActor);
+			}
+		});
+}
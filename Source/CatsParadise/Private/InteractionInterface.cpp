@@ -2,3 +2,63 @@
 
 #include "InteractionInterface.h"
 
+FInteractionDispatch FInteractionDispatch::Resolve(UObject* Object)
+{
+	FInteractionDispatch Dispatch;
+	if(!IsValid(Object) || !Object->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass()))
+	{
+		return Dispatch;
+	}
+
+	Dispatch.bImplementsInterface = true;
+
+	const UClass* Class = Object->GetClass();
+	if(HasBlueprintOverride(Class, GET_FUNCTION_NAME_CHECKED(IInteractionInterface, StartInteraction))
+		|| HasBlueprintOverride(Class, GET_FUNCTION_NAME_CHECKED(IInteractionInterface, FinishInteraction))
+		|| HasBlueprintOverride(Class, GET_FUNCTION_NAME_CHECKED(IInteractionInterface, StopInteraction)))
+	{
+		return Dispatch;
+	}
+
+	// null when the interface is only implemented by a Blueprint class
+	Dispatch.NativeInterface = Cast<IInteractionInterface>(Object);
+	return Dispatch;
+}
+
+bool FInteractionDispatch::HasBlueprintOverride(const UClass* Class, FName FunctionName)
+{
+	const UFunction* Function = Class ? Class->FindFunctionByName(FunctionName) : nullptr;
+	return Function && !Function->GetOwnerClass()->HasAnyClassFlags(CLASS_Native);
+}
+
+void FInteractionDispatch::StartInteraction(UObject* Object, AActor* OtherActor) const
+{
+	if(NativeInterface)
+	{
+		NativeInterface->StartInteraction_Implementation(OtherActor);
+		return;
+	}
+
+	IInteractionInterface::Execute_StartInteraction(Object, OtherActor);
+}
+
+bool FInteractionDispatch::FinishInteraction(UObject* Object, AActor* OtherActor) const
+{
+	if(NativeInterface)
+	{
+		return NativeInterface->FinishInteraction_Implementation(OtherActor);
+	}
+
+	return IInteractionInterface::Execute_FinishInteraction(Object, OtherActor);
+}
+
+void FInteractionDispatch::StopInteraction(UObject* Object, AActor* OtherActor) const
+{
+	if(NativeInterface)
+	{
+		NativeInterface->StopInteraction_Implementation(OtherActor);
+		return;
+	}
+
+	IInteractionInterface::Execute_StopInteraction(Object, OtherActor);
+}
@@ -1,8 +1,41 @@
 #include "InteractionQueueComponent.h"
 
+#include "InteractionGridSubsystem.h"
 #include "InteractionInterface.h"
+#include "PlayerFocusSubsystem.h"
+#include "Algo/BinarySearch.h"
 #include "GameFramework/Character.h"
 
+namespace InteractionQueueLocal
+{
+	// queue ranks, an actor in sight that requires it goes first, then everything that doesn't require sight
+	constexpr uint64 InSightRank = 0;
+	constexpr uint64 NoLineOfSightRank = 1;
+	constexpr uint64 LineOfSightRank = 2;
+
+	constexpr uint64 SequenceMask = 0xFFFFFFFF;
+
+	// the rank takes the top two bits of the key, the score the 30 bits below it
+	constexpr int32 RankShift = 62;
+	constexpr int32 ScoreShift = 32;
+	constexpr int32 ScoreBits = 30;
+
+	// targets and views moving less than this keep their score
+	constexpr float ScoreLocationTolerance = 1.f;
+	constexpr float ScoreDirectionTolerance = 1.e-3f;
+
+	// above this many changed targets the whole queue is sorted instead of moving them one by one
+	constexpr int32 MaxScoreReinserts = 8;
+
+	/** Maps the score to key bits that grow as the score drops, so the best target sorts first. */
+	uint64 EncodeScore(float Score)
+	{
+		uint32 Bits = FMath::IsNaN(Score) ? 0 : BitCast<uint32>(Score);
+		Bits = (Bits & 0x80000000) ? ~Bits : (Bits | 0x80000000);
+		return static_cast<uint64>(~Bits >> (32 - ScoreBits));
+	}
+}
+
 
 UInteractionQueueComponent::UInteractionQueueComponent()
 {
@@ -15,7 +48,25 @@ void UInteractionQueueComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	
+	if(UInteractionGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UInteractionGridSubsystem>(GetWorld()))
+	{
+		GridSubsystem->RegisterSeeker(GetOwner());
+	}
+}
+
+void UInteractionQueueComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(UPlayerFocusSubsystem* FocusSubsystem = UWorld::GetSubsystem<UPlayerFocusSubsystem>(GetWorld()))
+	{
+		FocusSubsystem->RemoveViewer(GetOwner());
+	}
+
+	if(UInteractionGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UInteractionGridSubsystem>(GetWorld()))
+	{
+		GridSubsystem->UnregisterSeeker(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 
@@ -23,44 +74,63 @@ void UInteractionQueueComponent::TickComponent(float DeltaTime, ELevelTick TickT
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	if(!IsQueueEmpty())
+	if(bUseLineOfSight && !IsQueueEmpty())
 	{
-		ActorInSight = GetActorInSight();
-		SortByLineOfSight(ActorInSight);
+		SetActorInSight(GetActorInSight());
+	}
+
+	if(bScoreTargets && !IsQueueEmpty())
+	{
+		UpdateTargetScores();
 	}
 
 }
 
 bool UInteractionQueueComponent::Add(AActor* Actor, const FInteractionData& InteractionData)
 {
-	if(!IsValid(Actor) && QueueHasActor(Actor) && !HasInteractionInterface(Actor))
+	if(!IsValid(Actor) || QueueHasActor(Actor))
 	{
 		return false;
 	}
-	
-	InteractionQueue.Add(FQueueData{Actor, InteractionData});
-	SortInteractionQueue();
+
+	const FInteractionDispatch Dispatch = FInteractionDispatch::Resolve(Actor);
+	if(!Dispatch.bImplementsInterface)
+	{
+		return false;
+	}
+
+	FQueueData Data{Actor, InteractionData};
+	Data.Dispatch = Dispatch;
+	if(bScoreTargets)
+	{
+		// the Scored* view stays the baseline of the other targets, UpdateTargetScores rescores them against it
+		FVector ViewLocation{FVector::ZeroVector};
+		FVector ViewDirection{FVector::ForwardVector};
+		GetScoringView(ViewLocation, ViewDirection);
+		Data.ScoredLocation = Actor->GetActorLocation();
+		Data.Score = ScoreQueueData(Data, GetOwner()->GetActorLocation(), ViewLocation, ViewDirection);
+	}
+	Data.SortKey = MakeSortKey(Data, NextQueueSequence++);
+	InsertQueueData(MoveTemp(Data));
+	QueueRevision++;
 	OnActorAdded.Broadcast(Actor);
 	return true;
 }
 
 bool UInteractionQueueComponent::Remove(const AActor* Actor)
 {
-	if(!IsValid(Actor) || !QueueHasActor(Actor))
+	const int32 Index = FindQueueIndex(Actor);
+	if(!IsValid(Actor) || Index == INDEX_NONE)
 	{
 		return false;
 	}
 
-	auto Predicate = [&](const FQueueData& Data) { return Data.Actor == Actor; };
-	const bool bItemsRemoved = InteractionQueue.RemoveAll(Predicate) > 0;
-
-	if(bItemsRemoved)
-	{
-		SortInteractionQueue();
-		OnActorRemoved.Broadcast(Actor);
-	}
-
-	return bItemsRemoved;
+	// removing keeps the rest of the queue in order
+	InteractionQueue.RemoveAt(Index);
+	QueueSortKeys.Remove(Actor);
+	QueueRevision++;
+	OnActorRemoved.Broadcast(Actor);
+	return true;
 }
 
 bool UInteractionQueueComponent::StartInteraction()
@@ -74,7 +144,7 @@ bool UInteractionQueueComponent::StartInteraction()
 	FQueueData Data;
 	GetFirstQueueData(Data);
 
-	if(!IsValid(Data.Actor) || !HasInteractionInterface(Data.Actor))
+	if(!IsValid(Data.Actor) || !Data.Dispatch.bImplementsInterface)
 	{
 		UE_LOG(LogTemp, Display, TEXT("no interface or is not valid"));
 		return false;
@@ -89,7 +159,7 @@ bool UInteractionQueueComponent::StartInteraction()
 	//TODO: If add timer -> add timer logic
 
 	OnInteractionStarted.Broadcast(Data.Actor);
-	IInteractionInterface::Execute_StartInteraction(Data.Actor, GetOwner());
+	Data.Dispatch.StartInteraction(Data.Actor, GetOwner());
 
 	return bFinishManually ? true : FinishInteractionByActor(GetFirstActor());
 }
@@ -102,14 +172,15 @@ bool UInteractionQueueComponent::StartInteractionByActor(AActor* Actor)
 		return false;
 	}
 	
-	if(!QueueHasActor(Actor) || !HasInteractionInterface(Actor))
+	const int32 Index = FindQueueIndex(Actor);
+	if(Index == INDEX_NONE || !InteractionQueue[Index].Dispatch.bImplementsInterface)
 	{
 		UE_LOG(LogTemp, Display, TEXT("no interface or is not in queue"));
 		return false;
 	}
 
-	FInteractionData InteractionData;
-	GetInteractionData(Actor, InteractionData);
+	const FInteractionData& InteractionData = InteractionQueue[Index].InteractionData;
+	const FInteractionDispatch Dispatch = InteractionQueue[Index].Dispatch;
 
 	if(InteractionData.bRequireLineOfSight && Actor != ActorInSight)
 	{
@@ -120,7 +191,7 @@ bool UInteractionQueueComponent::StartInteractionByActor(AActor* Actor)
 	//TODO: If add timer -> add timer logic
 
 	OnInteractionStarted.Broadcast(Actor);
-	IInteractionInterface::Execute_StartInteraction(Actor, GetOwner());
+	Dispatch.StartInteraction(Actor, GetOwner());
 
 	return bFinishManually ? true : FinishInteractionByActor(Actor);
 }
@@ -129,20 +200,20 @@ bool UInteractionQueueComponent::FinishInteractionByActor(AActor* Actor)
 {
 	bool bResult = false;
 
-	if(!QueueHasActor(Actor) || !HasInteractionInterface(Actor))
+	const int32 Index = FindQueueIndex(Actor);
+	if(Index == INDEX_NONE || !InteractionQueue[Index].Dispatch.bImplementsInterface)
 	{
 		return bResult;
 	}
 
-	FInteractionData InteractionData;
-	GetInteractionData(Actor, InteractionData);
-
-	if(InteractionData.bRequireLineOfSight && Actor != ActorInSight)
+	if(InteractionQueue[Index].InteractionData.bRequireLineOfSight && Actor != ActorInSight)
 	{
 		return bResult;
 	}
 
-	bResult = IInteractionInterface::Execute_FinishInteraction(Actor, GetOwner());
+	// the finish event may change the queue, so the dispatch is copied before calling it
+	const FInteractionDispatch Dispatch = InteractionQueue[Index].Dispatch;
+	bResult = Dispatch.FinishInteraction(Actor, GetOwner());
 	
 	if(bResult)
 	{
@@ -157,7 +228,8 @@ bool UInteractionQueueComponent::FinishInteractionByQueueData(FQueueData& Data)
 {
 	bool bResult = false;
 
-	if(!QueueHasActor(Data.Actor) || !HasInteractionInterface(Data.Actor))
+	const FInteractionDispatch Dispatch = GetInteractionDispatch(Data.Actor);
+	if(!QueueHasActor(Data.Actor) || !Dispatch.bImplementsInterface)
 	{
 		return bResult;
 	}
@@ -167,7 +239,7 @@ bool UInteractionQueueComponent::FinishInteractionByQueueData(FQueueData& Data)
 		return bResult;
 	}
 	
-	bResult = IInteractionInterface::Execute_FinishInteraction(Data.Actor, GetOwner());
+	bResult = Dispatch.FinishInteraction(Data.Actor, GetOwner());
 	
 	if(bResult)
 	{
@@ -180,43 +252,41 @@ bool UInteractionQueueComponent::FinishInteractionByQueueData(FQueueData& Data)
 
 bool UInteractionQueueComponent::StopInteraction()
 {
-	FInteractionData InteractionData;
-	GetFirstInteractionData(InteractionData);
-	AActor* Actor = GetFirstActor();
+	if(IsQueueEmpty())
+	{
+		return false;
+	}
 
-	if(!IsValid(Actor) || !HasInteractionInterface(Actor))
+	AActor* Actor = InteractionQueue[0].Actor;
+	const FInteractionDispatch Dispatch = InteractionQueue[0].Dispatch;
+
+	if(!IsValid(Actor) || !Dispatch.bImplementsInterface)
 	{
 		return false;
 	}
 
 	OnInteractionStopped.Broadcast(Actor);
-	IInteractionInterface::Execute_StopInteraction(Actor, GetOwner());
+	Dispatch.StopInteraction(Actor, GetOwner());
 	return true;
 }
 
 bool UInteractionQueueComponent::StopInteractionByActor(AActor* Actor)
 {
-	FInteractionData InteractionData;
-	GetInteractionData(Actor, InteractionData);
+	const FInteractionDispatch Dispatch = GetInteractionDispatch(Actor);
 
-	if(!IsValid(Actor) || !HasInteractionInterface(Actor))
+	if(!IsValid(Actor) || !Dispatch.bImplementsInterface)
 	{
 		return false;
 	}
 
 	OnInteractionStopped.Broadcast(Actor);
-	IInteractionInterface::Execute_StopInteraction(Actor, GetOwner());
+	Dispatch.StopInteraction(Actor, GetOwner());
 	return true;
 }
 
 bool UInteractionQueueComponent::HasInteractionInterface(AActor* Actor)
 {
-	if(!IsValid(Actor))
-	{
-		return false;
-	}
-
-	return Actor->GetClass()->ImplementsInterface(UInteractionInterface::StaticClass());
+	return GetInteractionDispatch(Actor).bImplementsInterface;
 }
 
 bool UInteractionQueueComponent::QueueHasActor(const AActor* Actor) const
@@ -226,8 +296,7 @@ bool UInteractionQueueComponent::QueueHasActor(const AActor* Actor) const
 		return false;
 	}
 
-	auto Predicate = [&](const FQueueData& Data) { return Data.Actor == Actor; };
-	return InteractionQueue.ContainsByPredicate(Predicate);
+	return QueueSortKeys.Contains(Actor);
 }
 
 bool UInteractionQueueComponent::GetFirstQueueData(FQueueData& QueueData)
@@ -286,8 +355,9 @@ bool UInteractionQueueComponent::GetInteractionData(AActor* Actor, FInteractionD
 
 FInteractionData& UInteractionQueueComponent::FindInteractionData(const AActor* Actor)
 {
-	auto Predicate = [&](const FQueueData& Data) { return Data.Actor == Actor; };
-	return InteractionQueue.FindByPredicate(Predicate)->InteractionData;
+	const int32 Index = FindQueueIndex(Actor);
+	check(Index != INDEX_NONE);
+	return InteractionQueue[Index].InteractionData;
 }
 
 void UInteractionQueueComponent::SortInteractionQueue()
@@ -297,11 +367,28 @@ void UInteractionQueueComponent::SortInteractionQueue()
 		return;
 	}
 
-	auto Predicate = [&] (const FQueueData& DataA, const FQueueData& DataB)
+	FVector ViewLocation{FVector::ZeroVector};
+	FVector ViewDirection{FVector::ForwardVector};
+	const FVector OwnerLocation = GetOwner()->GetActorLocation();
+	if(bScoreTargets)
 	{
-		return DataA.InteractionData.bRequireLineOfSight <= DataB.InteractionData.bRequireLineOfSight;
-	};
-	InteractionQueue.Sort(Predicate);
+		GetScoringView(ViewLocation, ViewDirection);
+	}
+
+	// the queue is kept in order as it changes, this only re-ranks after interaction data was edited in place
+	for(FQueueData& Data : InteractionQueue)
+	{
+		if(bScoreTargets && IsValid(Data.Actor))
+		{
+			Data.ScoredLocation = Data.Actor->GetActorLocation();
+			Data.Score = ScoreQueueData(Data, OwnerLocation, ViewLocation, ViewDirection);
+		}
+		Data.SortKey = MakeSortKey(Data, Data.SortKey & InteractionQueueLocal::SequenceMask);
+		QueueSortKeys.Add(Data.Actor, Data.SortKey);
+	}
+
+	// keys are unique, so the order is strict and deterministic
+	Algo::SortBy(InteractionQueue, &FQueueData::SortKey);
 }
 
 bool UInteractionQueueComponent::IsQueueEmpty()
@@ -317,7 +404,7 @@ bool UInteractionQueueComponent::GetUseLineOfSight() const
 void UInteractionQueueComponent::SetUseLineOfSight(const bool Value)
 {
 	bUseLineOfSight = Value;
-	SetComponentTickEnabled(bUseLineOfSight);
+	SetComponentTickEnabled(bUseLineOfSight || bScoreTargets);
 	SortInteractionQueue();
 }
 
@@ -339,7 +426,14 @@ bool UInteractionQueueComponent::GetPlayerViewport(const AActor* Actor, FVector&
 			return false;
 		}
 
-		Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		if(UPlayerFocusSubsystem* FocusSubsystem = UWorld::GetSubsystem<UPlayerFocusSubsystem>(GetWorld()))
+		{
+			FocusSubsystem->GetPlayerViewPoint(Controller, ViewLocation, ViewRotation);
+		}
+		else
+		{
+			Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		}
 	}
 
 	return true;
@@ -357,65 +451,195 @@ AActor* UInteractionQueueComponent::GetActorInSight()
 		return nullptr;
 	}
 
-	const FVector TraceStart {ViewLocation};
-	const FVector TraceDirection {ViewRotation.Vector()};
-	const FVector TraceEnd {TraceStart + TraceDirection * SightDistance};
-
-	if(!GetWorld())
+	UPlayerFocusSubsystem* FocusSubsystem = UWorld::GetSubsystem<UPlayerFocusSubsystem>(GetWorld());
+	if(!FocusSubsystem)
 	{
 		UE_LOG(LogTemp, Display, TEXT("No World"));
 		return nullptr;
 	}
 
-	FHitResult HitResult;
-	UKismetSystemLibrary::SphereTraceSingle(GetWorld(),
-		TraceStart,
-		TraceEnd,
-		SightRadius,
-		TraceChannel,
-		false,
-		{GetOwner()},
-		DebugTrace,
-		HitResult,
-		true,
-		FLinearColor::Red,
-		FLinearColor::Green,
-		DebugDrawTime);
-	return HitResult.GetActor();
+	return FocusSubsystem->GetFocusedActor(GetOwner(), ViewLocation, ViewRotation, GetSightTraceSettings(), QueueRevision);
+}
+
+FPlayerFocusTraceSettings UInteractionQueueComponent::GetSightTraceSettings() const
+{
+	FPlayerFocusTraceSettings Settings;
+	Settings.TraceChannel = TraceChannel;
+	Settings.Distance = SightDistance;
+	Settings.Radius = SightRadius;
+	Settings.DebugTrace = DebugTrace;
+	Settings.DebugDrawTime = DebugDrawTime;
+	return Settings;
+}
+
+void UInteractionQueueComponent::SetActorInSight(AActor* Actor)
+{
+	if(ActorInSight == Actor)
+	{
+		return;
+	}
+
+	const AActor* PreviousActorInSight = ActorInSight;
+	ActorInSight = Actor;
+
+	// only the actors entering and leaving the sight change rank
+	RefreshSortKey(PreviousActorInSight);
+	RefreshSortKey(ActorInSight);
 }
 
-void UInteractionQueueComponent::SortByLineOfSight(const AActor* Actor)
+uint64 UInteractionQueueComponent::MakeSortKey(const FQueueData& Data, uint32 Sequence) const
 {
-	FInteractionData InteractionData;
+	using namespace InteractionQueueLocal;
 
-	if(!IsValid(Actor) || !QueueHasActor(Actor))
+	uint64 Rank = NoLineOfSightRank;
+	if(Data.InteractionData.bRequireLineOfSight)
 	{
-		UE_LOG(LogTemp, Display, TEXT("Not Valid Actor"));
-		GetFirstInteractionData(InteractionData);
+		Rank = Data.Actor == ActorInSight ? InSightRank : LineOfSightRank;
+	}
 
-		if(InteractionData.bRequireLineOfSight)
-		{
-			SortInteractionQueue();
-		}
-		
+	const uint64 Score = bScoreTargets ? EncodeScore(Data.Score) : 0;
+	return (Rank << RankShift) | (Score << ScoreShift) | Sequence;
+}
+
+int32 UInteractionQueueComponent::FindQueueIndex(const AActor* Actor) const
+{
+	const uint64* SortKey = QueueSortKeys.Find(Actor);
+	if(!SortKey)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Index = Algo::LowerBoundBy(InteractionQueue, *SortKey, &FQueueData::SortKey);
+	return InteractionQueue.IsValidIndex(Index) && InteractionQueue[Index].SortKey == *SortKey ? Index : INDEX_NONE;
+}
+
+void UInteractionQueueComponent::InsertQueueData(FQueueData&& Data)
+{
+	QueueSortKeys.Add(Data.Actor, Data.SortKey);
+
+	const int32 Index = Algo::UpperBoundBy(InteractionQueue, Data.SortKey, &FQueueData::SortKey);
+	InteractionQueue.Insert(MoveTemp(Data), Index);
+}
+
+FInteractionDispatch UInteractionQueueComponent::GetInteractionDispatch(AActor* Actor) const
+{
+	// queued actors were resolved when they were added
+	const int32 Index = FindQueueIndex(Actor);
+	return Index != INDEX_NONE ? InteractionQueue[Index].Dispatch : FInteractionDispatch::Resolve(Actor);
+}
+
+void UInteractionQueueComponent::RefreshSortKey(const AActor* Actor)
+{
+	const int32 Index = FindQueueIndex(Actor);
+	if(Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	const uint64 SortKey = MakeSortKey(InteractionQueue[Index], InteractionQueue[Index].SortKey & InteractionQueueLocal::SequenceMask);
+	if(SortKey == InteractionQueue[Index].SortKey)
+	{
 		return;
 	}
 
-	auto Predicate = [&](const FQueueData& Data) {return Data.Actor == Actor;};
-	const FQueueData QueueData = *InteractionQueue.FindByPredicate(Predicate);
-	InteractionData = QueueData.InteractionData;
+	FQueueData Data = MoveTemp(InteractionQueue[Index]);
+	InteractionQueue.RemoveAt(Index);
+	Data.SortKey = SortKey;
+	InsertQueueData(MoveTemp(Data));
+}
+
+float UInteractionQueueComponent::ScoreQueueData(const FQueueData& Data, const FVector& OwnerLocation,
+	const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+	float Score = Data.InteractionData.Priority * PriorityWeight;
+	Score -= DistanceWeight * FVector::Dist(OwnerLocation, Data.ScoredLocation) / 100.f;
+	Score += ViewAngleWeight * (ViewDirection | (Data.ScoredLocation - ViewLocation).GetSafeNormal());
+	return Score;
+}
+
+void UInteractionQueueComponent::GetScoringView(FVector& ViewLocation, FVector& ViewDirection)
+{
+	// players score from their camera, everything else from its eyes
+	FRotator ViewRotation{FRotator::ZeroRotator};
+	GetOwner()->GetActorEyesViewPoint(ViewLocation, ViewRotation);
+	GetPlayerViewport(GetOwner(), ViewLocation, ViewRotation);
+	ViewDirection = ViewRotation.Vector();
+}
+
+void UInteractionQueueComponent::UpdateTargetScores()
+{
+	using namespace InteractionQueueLocal;
+
+	FVector ViewLocation{FVector::ZeroVector};
+	FVector ViewDirection{FVector::ForwardVector};
+	GetScoringView(ViewLocation, ViewDirection);
+	const FVector OwnerLocation = GetOwner()->GetActorLocation();
 
-	if(InteractionData.bRequireLineOfSight)
+	const bool bViewChanged = !ViewLocation.Equals(ScoredViewLocation, ScoreLocationTolerance)
+		|| !ViewDirection.Equals(ScoredViewDirection, ScoreDirectionTolerance)
+		|| !OwnerLocation.Equals(ScoredOwnerLocation, ScoreLocationTolerance);
+	if(bViewChanged)
 	{
-		if(ActorInSight != QueueData.Actor)
+		ScoredViewLocation = ViewLocation;
+		ScoredViewDirection = ViewDirection;
+		ScoredOwnerLocation = OwnerLocation;
+	}
+
+	// only targets whose inputs changed are rescored, and only the ones whose key changed move
+	TArray<TPair<int32, uint64>, TInlineAllocator<MaxScoreReinserts>> ChangedKeys;
+	for(int32 Index = 0; Index < InteractionQueue.Num(); Index++)
+	{
+		FQueueData& Data = InteractionQueue[Index];
+		if(!IsValid(Data.Actor))
+		{
+			continue;
+		}
+
+		const FVector ActorLocation = Data.Actor->GetActorLocation();
+		if(!bViewChanged && ActorLocation.Equals(Data.ScoredLocation, ScoreLocationTolerance))
+		{
+			continue;
+		}
+
+		Data.ScoredLocation = ActorLocation;
+		Data.Score = ScoreQueueData(Data, ScoredOwnerLocation, ScoredViewLocation, ScoredViewDirection);
+
+		const uint64 SortKey = MakeSortKey(Data, Data.SortKey & SequenceMask);
+		if(SortKey != Data.SortKey)
 		{
-			UE_LOG(LogTemp, Display, TEXT("Actor in sight != actor from queueData, stop interaction"));
-			StopInteraction();
+			ChangedKeys.Emplace(Index, SortKey);
 		}
+	}
 
-		const int32 Index = InteractionQueue.IndexOfByPredicate(Predicate);
-		InteractionQueue.Swap(Index, 0);
+	if(ChangedKeys.IsEmpty())
+	{
+		return;
 	}
-}
 
+	if(ChangedKeys.Num() > MaxScoreReinserts)
+	{
+		for(const TPair<int32, uint64>& ChangedKey : ChangedKeys)
+		{
+			FQueueData& Data = InteractionQueue[ChangedKey.Key];
+			Data.SortKey = ChangedKey.Value;
+			QueueSortKeys.Add(Data.Actor, Data.SortKey);
+		}
+		Algo::SortBy(InteractionQueue, &FQueueData::SortKey);
+		return;
+	}
+
+	// take the changed targets out back to front, the rest stays sorted, then insert them at their new place
+	TArray<FQueueData, TInlineAllocator<MaxScoreReinserts>> ChangedData;
+	for(int32 ChangedIndex = ChangedKeys.Num() - 1; ChangedIndex >= 0; ChangedIndex--)
+	{
+		const TPair<int32, uint64>& ChangedKey = ChangedKeys[ChangedIndex];
+		FQueueData& Data = ChangedData.Add_GetRef(MoveTemp(InteractionQueue[ChangedKey.Key]));
+		Data.SortKey = ChangedKey.Value;
+		InteractionQueue.RemoveAt(ChangedKey.Key, 1, false);
+	}
 
+	for(FQueueData& Data : ChangedData)
+	{
+		InsertQueueData(MoveTemp(Data));
+	}
+}
@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "NiagaraDataInterfaceOceanSampler.h"
+
+#include "OceanWaterZone.h"
+#include "EngineUtils.h"
+#include "NiagaraSystemInstance.h"
+#include "NiagaraTypes.h"
+#include "VectorVM.h"
+
+#define LOCTEXT_NAMESPACE "NiagaraDataInterfaceOceanSampler"
+
+namespace NDIOceanSamplerLocal
+{
+	static const FName SampleOceanName(TEXT("SampleOcean"));
+
+	// particles are gathered into SoA chunks of this size for each batched lookup
+	static constexpr int32 SampleChunkSize = 256;
+}
+
+struct FNDIOceanSamplerInstanceData
+{
+	TWeakObjectPtr<AOceanWaterZone> OceanWaterZone;
+	FOceanDisplacementSnapshotPtr Snapshot;
+	// simulation positions are relative to the system's large world tile
+	FVector LWCOffset = FVector::ZeroVector;
+};
+
+void UNiagaraDataInterfaceOceanSampler::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ENiagaraTypeRegistryFlags Flags = ENiagaraTypeRegistryFlags::AllowAnyVariable | ENiagaraTypeRegistryFlags::AllowParameter;
+		FNiagaraTypeRegistry::Register(FNiagaraTypeDefinition(GetClass()), Flags);
+	}
+}
+
+void UNiagaraDataInterfaceOceanSampler::GetFunctions(TArray<FNiagaraFunctionSignature>& OutFunctions)
+{
+	FNiagaraFunctionSignature& Signature = OutFunctions.AddDefaulted_GetRef();
+	Signature.Name = NDIOceanSamplerLocal::SampleOceanName;
+	Signature.bMemberFunction = true;
+	Signature.bRequiresContext = false;
+	Signature.Inputs.Add(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("OceanSampler")));
+	Signature.Inputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetPositionDef(), TEXT("Position")));
+	Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetVec3Def(), TEXT("Displacement")));
+	Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetPositionDef(), TEXT("SurfacePosition")));
+#if WITH_EDITORONLY_DATA
+	Signature.Description = LOCTEXT("SampleOceanDescription", "Samples the CPU ocean displacement under Position. SurfacePosition is the displaced point on the ocean surface.");
+#endif
+}
+
+void UNiagaraDataInterfaceOceanSampler::GetVMExternalFunction(const FVMExternalFunctionBindingInfo& BindingInfo, void* InstanceData, FVMExternalFunction& OutFunc)
+{
+	if (BindingInfo.Name == NDIOceanSamplerLocal::SampleOceanName)
+	{
+		OutFunc = FVMExternalFunction::CreateUObject(this, &UNiagaraDataInterfaceOceanSampler::SampleOcean);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not find data interface external function in %s. Received Name: %s"), *GetPathNameSafe(this), *BindingInfo.Name.ToString());
+	}
+}
+
+int32 UNiagaraDataInterfaceOceanSampler::PerInstanceDataSize() const
+{
+	return sizeof(FNDIOceanSamplerInstanceData);
+}
+
+bool UNiagaraDataInterfaceOceanSampler::InitPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance)
+{
+	FNDIOceanSamplerInstanceData* InstanceData = new (PerInstanceData) FNDIOceanSamplerInstanceData();
+
+	for (TActorIterator<AOceanWaterZone> It(SystemInstance->GetWorld()); It; ++It)
+	{
+		InstanceData->OceanWaterZone = *It;
+		break;
+	}
+
+	if (!InstanceData->OceanWaterZone.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("WaterZone isn't valid"));
+	}
+
+	// an instance without an ocean still runs, it just samples a flat surface
+	return true;
+}
+
+void UNiagaraDataInterfaceOceanSampler::DestroyPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance)
+{
+	FNDIOceanSamplerInstanceData* InstanceData = static_cast<FNDIOceanSamplerInstanceData*>(PerInstanceData);
+	InstanceData->~FNDIOceanSamplerInstanceData();
+}
+
+bool UNiagaraDataInterfaceOceanSampler::PerInstanceTick(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance, float DeltaSeconds)
+{
+	FNDIOceanSamplerInstanceData* InstanceData = static_cast<FNDIOceanSamplerInstanceData*>(PerInstanceData);
+
+	if (AOceanWaterZone* OceanWaterZone = InstanceData->OceanWaterZone.Get())
+	{
+		InstanceData->Snapshot = OceanWaterZone->FFTCalculator.GetDisplacementSnapshot();
+	}
+	else
+	{
+		InstanceData->Snapshot.Reset();
+	}
+
+	InstanceData->LWCOffset = FVector(SystemInstance->GetLWCTile()) * FLargeWorldRenderScalar::GetTileSize();
+	return false;
+}
+
+void UNiagaraDataInterfaceOceanSampler::SampleOcean(FVectorVMExternalFunctionContext& Context)
+{
+	using namespace NDIOceanSamplerLocal;
+
+	VectorVM::FUserPtrHandler<FNDIOceanSamplerInstanceData> InstanceData(Context);
+
+	VectorVM::FExternalFuncInputHandler<float> InPositionX(Context);
+	VectorVM::FExternalFuncInputHandler<float> InPositionY(Context);
+	VectorVM::FExternalFuncInputHandler<float> InPositionZ(Context);
+
+	VectorVM::FExternalFuncRegisterHandler<float> OutDisplacementX(Context);
+	VectorVM::FExternalFuncRegisterHandler<float> OutDisplacementY(Context);
+	VectorVM::FExternalFuncRegisterHandler<float> OutDisplacementZ(Context);
+	VectorVM::FExternalFuncRegisterHandler<float> OutSurfaceX(Context);
+	VectorVM::FExternalFuncRegisterHandler<float> OutSurfaceY(Context);
+	VectorVM::FExternalFuncRegisterHandler<float> OutSurfaceZ(Context);
+
+	const FOceanDisplacementSnapshot* Snapshot = InstanceData->Snapshot.Get();
+	const FVector LWCOffset = InstanceData->LWCOffset;
+
+	float LocalX[SampleChunkSize];
+	float LocalY[SampleChunkSize];
+	float LocalZ[SampleChunkSize];
+	float WorldX[SampleChunkSize];
+	float WorldY[SampleChunkSize];
+	float DisplacementX[SampleChunkSize];
+	float DisplacementY[SampleChunkSize];
+	float DisplacementZ[SampleChunkSize];
+
+	const int32 NumInstances = Context.GetNumInstances();
+	for (int32 ChunkStart = 0; ChunkStart < NumInstances; ChunkStart += SampleChunkSize)
+	{
+		const int32 ChunkNum = FMath::Min(SampleChunkSize, NumInstances - ChunkStart);
+
+		for (int32 Index = 0; Index < ChunkNum; Index++)
+		{
+			LocalX[Index] = InPositionX.GetAndAdvance();
+			LocalY[Index] = InPositionY.GetAndAdvance();
+			LocalZ[Index] = InPositionZ.GetAndAdvance();
+			WorldX[Index] = LocalX[Index] + LWCOffset.X;
+			WorldY[Index] = LocalY[Index] + LWCOffset.Y;
+		}
+
+		if (Snapshot)
+		{
+			Snapshot->SampleDisplacements(WorldX, WorldY, DisplacementX, DisplacementY, DisplacementZ, ChunkNum);
+		}
+		else
+		{
+			FMemory::Memzero(DisplacementX, ChunkNum * sizeof(float));
+			FMemory::Memzero(DisplacementY, ChunkNum * sizeof(float));
+			FMemory::Memzero(DisplacementZ, ChunkNum * sizeof(float));
+		}
+
+		for (int32 Index = 0; Index < ChunkNum; Index++)
+		{
+			*OutDisplacementX.GetDestAndAdvance() = DisplacementX[Index];
+			*OutDisplacementY.GetDestAndAdvance() = DisplacementY[Index];
+			*OutDisplacementZ.GetDestAndAdvance() = DisplacementZ[Index];
+
+			// the undisplaced ocean surface sits at world Z 0, same as the buoyancy sampling
+			*OutSurfaceX.GetDestAndAdvance() = LocalX[Index] + DisplacementX[Index];
+			*OutSurfaceY.GetDestAndAdvance() = LocalY[Index] + DisplacementY[Index];
+			*OutSurfaceZ.GetDestAndAdvance() = DisplacementZ[Index] - LWCOffset.Z;
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -333,6 +333,96 @@ FVector FOceanFFTCalculator::GetDisplacementAtPoint(FVector PointLocation)
     return Displacement;
 }
 
+void FOceanFFTCalculator::GetDisplacementAtPoints(TConstArrayView<FVector> PointLocations, TArrayView<FVector> OutDisplacements)
+{
+    check(PointLocations.Num() == OutDisplacements.Num());
+
+    OCEAN_SCOPE_CYCLE_COUNTER(OceanSampleDisplacements);
+
+    float PositionX[SampleChunkSize];
+    float PositionY[SampleChunkSize];
+    float DisplacementX[SampleChunkSize];
+    float DisplacementY[SampleChunkSize];
+    float DisplacementZ[SampleChunkSize];
+
+    for (int32 ChunkStart = 0; ChunkStart < PointLocations.Num(); ChunkStart += SampleChunkSize)
+    {
+        const int32 ChunkNum = FMath::Min(SampleChunkSize, PointLocations.Num() - ChunkStart);
+
+        for (int32 Index = 0; Index < ChunkNum; Index++)
+        {
+            PositionX[Index] = PointLocations[ChunkStart + Index].X;
+            PositionY[Index] = PointLocations[ChunkStart + Index].Y;
+        }
+
+        ispc::FOceanFFTCalculator_SampleDisplacements(
+            OceanData.DisplacementGridX,
+            OceanData.DisplacementGridY,
+            OceanData.DisplacementGridZ,
+            OceanData.PatchLength,
+            OceanData.GridSize,
+            OceanData.NumCascades,
+            PositionX,
+            PositionY,
+            DisplacementX,
+            DisplacementY,
+            DisplacementZ,
+            ChunkNum
+        );
+
+        for (int32 Index = 0; Index < ChunkNum; Index++)
+        {
+            OutDisplacements[ChunkStart + Index] = FVector(DisplacementX[Index], DisplacementY[Index], DisplacementZ[Index]);
+        }
+    }
+}
+
+FOceanDisplacementSnapshotPtr FOceanFFTCalculator::GetDisplacementSnapshot()
+{
+    check(IsInGameThread());
+
+    if (CurrentSnapshotIndex != INDEX_NONE && DisplacementSnapshots[CurrentSnapshotIndex]->EngineTime == CalculatedEngineTime)
+        return DisplacementSnapshots[CurrentSnapshotIndex];
+
+    OCEAN_SCOPE_CYCLE_COUNTER(OceanCopyDisplacementSnapshot);
+
+    const int32 NextSnapshotIndex = (CurrentSnapshotIndex + 1) % UE_ARRAY_COUNT(DisplacementSnapshots);
+    TSharedPtr<FOceanDisplacementSnapshot, ESPMode::ThreadSafe>& Snapshot = DisplacementSnapshots[NextSnapshotIndex];
+
+    // someone is still reading the old data in this slot, leave it to them and allocate a new one
+    if (!Snapshot.IsValid() || !Snapshot.IsUnique())
+    {
+        Snapshot = MakeShared<FOceanDisplacementSnapshot, ESPMode::ThreadSafe>();
+    }
+
+    FMemory::Memcpy(Snapshot->PatchLength, OceanData.PatchLength, sizeof(OceanData.PatchLength));
+    FMemory::Memcpy(Snapshot->DisplacementGridX, OceanData.DisplacementGridX, sizeof(OceanData.DisplacementGridX));
+    FMemory::Memcpy(Snapshot->DisplacementGridY, OceanData.DisplacementGridY, sizeof(OceanData.DisplacementGridY));
+    FMemory::Memcpy(Snapshot->DisplacementGridZ, OceanData.DisplacementGridZ, sizeof(OceanData.DisplacementGridZ));
+    Snapshot->EngineTime = CalculatedEngineTime;
+
+    CurrentSnapshotIndex = NextSnapshotIndex;
+    return Snapshot;
+}
+
+void FOceanDisplacementSnapshot::SampleDisplacements(const float* PositionX, const float* PositionY, float* OutDisplacementX, float* OutDisplacementY, float* OutDisplacementZ, int32 NumPoints) const
+{
+    ispc::FOceanFFTCalculator_SampleDisplacements(
+        DisplacementGridX,
+        DisplacementGridY,
+        DisplacementGridZ,
+        PatchLength,
+        GRID_SIZE,
+        NUM_CASCADES,
+        PositionX,
+        PositionY,
+        OutDisplacementX,
+        OutDisplacementY,
+        OutDisplacementZ,
+        NumPoints
+    );
+}
+
 FIntVector4 FOceanFFTCalculator::GetBoundingArrayIndexesFromUV(float U, float V, int32 ArraySize, bool bWrap)
 {    
     const float X = U * (float)(ArraySize) - 0.5f;
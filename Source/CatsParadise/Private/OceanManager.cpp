@@ -1,4 +1,28 @@
 ﻿#include "OceanManager.h"
+#include "OceanManager.ispc.generated.h"
+#include "Async/ParallelFor.h"
+
+namespace OceanManagerLocal
+{
+ constexpr int32 NumClusters = 2;
+ constexpr int32 WavesPerCluster = 8;
+
+ // wavelength and amplitude multiplier, angle offset and phase offset of each wave in a cluster
+ constexpr float WaveScales[WavesPerCluster] = { 1.f, 0.5f, 2.0f, 1.25f, 0.75f, 1.5f, 0.825f, 0.65f };
+ constexpr float WaveAngles[WavesPerCluster] = { 0.f, -0.058f, -0.047f, 0.05f, 0.075f, -0.083f, 0.063f, -0.011f };
+ constexpr float WavePhases[WavesPerCluster] = { 0.f, 1.f, -1.5f, 0.75f, -0.6f, 0.9f, -0.23f, 1.72f };
+
+ // the wave phase advances by exactly the time, so every wave repeats after 2 PI seconds
+ constexpr double AnimationPeriod = UE_DOUBLE_TWO_PI;
+
+ // points compared against the analytic waves after baking
+ constexpr int32 ValidationGridSize = 16;
+
+ // the bake settings can be written from Blueprint, so they are clamped again before baking
+ int32 GetBakedGridSize(int32 GridSize) { return FMath::Clamp(GridSize, 8, 256); }
+ int32 GetBakedFrameCount(int32 FrameCount) { return FMath::Clamp(FrameCount, 4, 128); }
+ float GetBakedTileSize(float TileSize) { return FMath::Max(TileSize, 1000.f); }
+}
 
 AOceanManager::AOceanManager()
 {
@@ -11,54 +35,343 @@ AOceanManager::AOceanManager()
 
 void AOceanManager::Initialize()
 {
+ BuildWaves();
 
+ if (bBakeWaves)
+ {
+  BakeWaves();
+ }
 }
 
+#if WITH_EDITOR
+void AOceanManager::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+ Super::PostEditChangeProperty(PropertyChangedEvent);
+
+ BuildWaves();
+}
+#endif
 
 FVector AOceanManager::GetWaveHeightValue(FVector location, float time)
 {
+ FVector value = FVector(0, 0, 0);
+ GetWaveHeightValues(MakeArrayView(&location, 1), time, MakeArrayView(&value, 1));
+ return value;
+}
+
+FVector AOceanManager::GetAnalyticWaveHeightValue(FVector location, float time)
+{
+ UpdateWaves();
+
  //Calculate gerstner wave
  FVector sum = FVector(0, 0, 0);
 
- sum += CalculateGerstnerWaveCluster(Wavelength, Amplitude, FVector2D(location.X, location.Y), Direction, -0.015f, 0.5f, time, 0);
- sum += CalculateGerstnerWaveCluster(Wavelength * 0.6f, Amplitude * 0.6f, FVector2D(location.X, location.Y), Direction, 0.015f, 0.5f, time, 1.2f);
+ for (int32 i = 0; i < FOceanGerstnerWaves::NumWaves; i++)
+ {
+  float wavePhase = Waves.WaveNumber[i] * (Waves.DirectionX[i] * location.X + Waves.DirectionY[i] * location.Y) + time + Waves.Phase[i];
+
+  float c = FMath::Cos(wavePhase);
+  float s = FMath::Sin(wavePhase);
 
- return sum / 2;
+  sum += FVector(Waves.HorizontalAmplitudeX[i] * c, Waves.HorizontalAmplitudeY[i] * c, Waves.VerticalAmplitude[i] * s);
+ }
+
+ return sum;
 }
 
-FVector AOceanManager::CalculateGerstnerWaveCluster(float medianWavelength, float medianAmplitude, FVector2D position, FVector2D medianDirection, float medianAngle, float steepness, float time, float medianPhase)
+void AOceanManager::GetWaveHeightValues(TConstArrayView<FVector> Locations, float Time, TArrayView<FVector> OutValues)
 {
- //Calculate gerstner wave
- FVector sum = FVector(0, 0, 0);
+ check(Locations.Num() == OutValues.Num());
+
+ UpdateWaves();
+
+ if (bWavesBaked)
+ {
+  SampleBakedWaves(Locations, Time, OutValues);
+ }
+ else
+ {
+  EvaluateWaves(Waves, Locations, Time, OutValues);
+ }
+}
+
+void AOceanManager::GetOceanDisplacements(TConstArrayView<FVector> Locations, TArrayView<FVector> OutDisplacements)
+{
+ const UWorld* World = GetWorld();
+ GetWaveHeightValues(Locations, World ? World->GetTimeSeconds() : 0.f, OutDisplacements);
+}
+
+void AOceanManager::EvaluateWaves(const FOceanGerstnerWaves& WaveSet, TConstArrayView<FVector> Locations, float Time, TArrayView<FVector> OutValues) const
+{
+ float PositionX[SampleChunkSize];
+ float PositionY[SampleChunkSize];
+ float ValueX[SampleChunkSize];
+ float ValueY[SampleChunkSize];
+ float ValueZ[SampleChunkSize];
+
+ for (int32 ChunkStart = 0; ChunkStart < Locations.Num(); ChunkStart += SampleChunkSize)
+ {
+  const int32 ChunkNum = FMath::Min(SampleChunkSize, Locations.Num() - ChunkStart);
+
+  for (int32 Index = 0; Index < ChunkNum; Index++)
+  {
+   PositionX[Index] = Locations[ChunkStart + Index].X;
+   PositionY[Index] = Locations[ChunkStart + Index].Y;
+  }
+
+  ispc::FOceanManager_GerstnerWaves(
+   WaveSet.DirectionX,
+   WaveSet.DirectionY,
+   WaveSet.WaveNumber,
+   WaveSet.Phase,
+   WaveSet.HorizontalAmplitudeX,
+   WaveSet.HorizontalAmplitudeY,
+   WaveSet.VerticalAmplitude,
+   FOceanGerstnerWaves::NumWaves,
+   PositionX,
+   PositionY,
+   Time,
+   ValueX,
+   ValueY,
+   ValueZ,
+   ChunkNum
+  );
+
+  for (int32 Index = 0; Index < ChunkNum; Index++)
+  {
+   OutValues[ChunkStart + Index] = FVector(ValueX[Index], ValueY[Index], ValueZ[Index]);
+  }
+ }
+}
+
+void AOceanManager::SampleBakedWaves(TConstArrayView<FVector> Locations, float Time, TArrayView<FVector> OutValues) const
+{
+ // the two frames around the time and how far between them it is, shared by the whole batch
+ double FramePosition = FMath::Fmod((double)Time / OceanManagerLocal::AnimationPeriod, 1.0);
+ if (FramePosition < 0) { FramePosition += 1.0; }
+ FramePosition *= BakedFrameCountUsed;
+
+ const int32 Frame0 = FMath::Min(FMath::FloorToInt32(FramePosition), BakedFrameCountUsed - 1);
+ const int32 Frame1 = (Frame0 + 1) % BakedFrameCountUsed;
+ const float FrameAlpha = FramePosition - Frame0;
+
+ float PositionX[SampleChunkSize];
+ float PositionY[SampleChunkSize];
+ float ValueX[SampleChunkSize];
+ float ValueY[SampleChunkSize];
+ float ValueZ[SampleChunkSize];
+
+ for (int32 ChunkStart = 0; ChunkStart < Locations.Num(); ChunkStart += SampleChunkSize)
+ {
+  const int32 ChunkNum = FMath::Min(SampleChunkSize, Locations.Num() - ChunkStart);
+
+  for (int32 Index = 0; Index < ChunkNum; Index++)
+  {
+   PositionX[Index] = Locations[ChunkStart + Index].X;
+   PositionY[Index] = Locations[ChunkStart + Index].Y;
+  }
+
+  ispc::FOceanManager_SampleBakedWaves(
+   BakedX.GetData(),
+   BakedY.GetData(),
+   BakedZ.GetData(),
+   BakedGridSizeUsed,
+   BakedInvTileSize,
+   Frame0,
+   Frame1,
+   FrameAlpha,
+   PositionX,
+   PositionY,
+   ValueX,
+   ValueY,
+   ValueZ,
+   ChunkNum
+  );
 
- sum += CalculateGerstnerWave(medianWavelength, medianAmplitude, position, medianDirection, medianAngle + 0, steepness, time, medianPhase);
- sum += CalculateGerstnerWave(medianWavelength * 0.5f, medianAmplitude * 0.5f, position, medianDirection, medianAngle - 0.058f, steepness, time, medianPhase + 1);
- sum += CalculateGerstnerWave(medianWavelength * 2.0f, medianAmplitude * 2.0f, position, medianDirection, medianAngle - 0.047f, steepness, time, medianPhase - 1.5f);
- sum += CalculateGerstnerWave(medianWavelength * 1.25f, medianAmplitude * 1.25f, position, medianDirection, medianAngle + 0.05f, steepness, time, medianPhase + 0.75f);
- sum += CalculateGerstnerWave(medianWavelength * 0.75f, medianAmplitude * 0.75f, position, medianDirection, medianAngle + 0.075f, steepness, time, medianPhase - 0.6f);
- sum += CalculateGerstnerWave(medianWavelength * 1.5f, medianAmplitude * 1.5f, position, medianDirection, medianAngle - 0.083f, steepness, time, medianPhase + 0.9f);
- sum += CalculateGerstnerWave(medianWavelength * 0.825f, medianAmplitude * 0.825f, position, medianDirection, medianAngle + 0.063f, steepness, time, medianPhase - 0.23f);
- sum += CalculateGerstnerWave(medianWavelength * 0.65f, medianAmplitude * 0.65f, position, medianDirection, medianAngle - 0.011f, steepness, time, medianPhase + 1.72f);
+  for (int32 Index = 0; Index < ChunkNum; Index++)
+  {
+   OutValues[ChunkStart + Index] = FVector(ValueX[Index], ValueY[Index], ValueZ[Index]);
+  }
+ }
+}
+
+void AOceanManager::UpdateWaves()
+{
+ if (!bWavesBuilt || BuiltWavelength != Wavelength || BuiltAmplitude != Amplitude || BuiltDirection != Direction)
+ {
+  BuildWaves();
+ }
+
+ if (bBakeWaves && (!bWavesBaked || IsBakeOutOfDate()))
+ {
+  BakeWaves();
+ }
+ else if (!bBakeWaves)
+ {
+  bWavesBaked = false;
+ }
+}
+
+bool AOceanManager::IsBakeOutOfDate() const
+{
+ using namespace OceanManagerLocal;
+
+ return BakedGridSizeUsed != GetBakedGridSize(BakedGridSize)
+  || BakedFrameCountUsed != GetBakedFrameCount(BakedFrameCount)
+  || BakedTileSizeUsed != GetBakedTileSize(BakedTileSize);
+}
+
+void AOceanManager::BuildWaves()
+{
+ AddWaveCluster(0, Wavelength, Amplitude, -0.015f, 0.5f, 0);
+ AddWaveCluster(OceanManagerLocal::WavesPerCluster, Wavelength * 0.6f, Amplitude * 0.6f, 0.015f, 0.5f, 1.2f);
+
+ bWavesBuilt = true;
+ BuiltWavelength = Wavelength;
+ BuiltAmplitude = Amplitude;
+ BuiltDirection = Direction;
+
+ // the baked table is out of date, UpdateWaves bakes it again on the next lookup
+ bWavesBaked = false;
+}
+
+void AOceanManager::BakeWaves()
+{
+ using namespace OceanManagerLocal;
+
+ const double StartTime = FPlatformTime::Seconds();
+
+ BakedGridSizeUsed = GetBakedGridSize(BakedGridSize);
+ BakedFrameCountUsed = GetBakedFrameCount(BakedFrameCount);
+ BakedTileSizeUsed = GetBakedTileSize(BakedTileSize);
+ BakedInvTileSize = 1.f / BakedTileSizeUsed;
+ SnapWavesToTile();
+
+ const int32 CellsPerFrame = BakedGridSizeUsed * BakedGridSizeUsed;
+ BakedX.SetNumUninitialized(CellsPerFrame * BakedFrameCountUsed);
+ BakedY.SetNumUninitialized(CellsPerFrame * BakedFrameCountUsed);
+ BakedZ.SetNumUninitialized(CellsPerFrame * BakedFrameCountUsed);
 
- return sum / 8;
+ const float CellSize = BakedTileSizeUsed / BakedGridSizeUsed;
+
+ ParallelFor(BakedFrameCountUsed, [&](int32 Frame)
+ {
+  const float FrameTime = AnimationPeriod * Frame / BakedFrameCountUsed;
+
+  TArray<FVector> CellLocations;
+  TArray<FVector> CellValues;
+  CellLocations.SetNumUninitialized(BakedGridSizeUsed);
+  CellValues.SetNumUninitialized(BakedGridSizeUsed);
+
+  for (int32 Y = 0; Y < BakedGridSizeUsed; Y++)
+  {
+   for (int32 X = 0; X < BakedGridSizeUsed; X++)
+   {
+    CellLocations[X] = FVector(X * CellSize, Y * CellSize, 0);
+   }
+
+   EvaluateWaves(BakedWaves, CellLocations, FrameTime, CellValues);
+
+   const int32 RowOffset = Frame * CellsPerFrame + Y * BakedGridSizeUsed;
+   for (int32 X = 0; X < BakedGridSizeUsed; X++)
+   {
+    BakedX[RowOffset + X] = CellValues[X].X;
+    BakedY[RowOffset + X] = CellValues[X].Y;
+    BakedZ[RowOffset + X] = CellValues[X].Z;
+   }
+  }
+ });
+
+ bWavesBaked = true;
+
+ // compare the table against the exact waves between the baked cells, off the frame times,
+ // this includes both the snapping and the interpolation error
+ TArray<FVector> ValidationLocations;
+ for (int32 Y = 0; Y < ValidationGridSize; Y++)
+ {
+  for (int32 X = 0; X < ValidationGridSize; X++)
+  {
+   ValidationLocations.Add(FVector((X + 0.37f) * BakedTileSizeUsed / ValidationGridSize, (Y + 0.61f) * BakedTileSizeUsed / ValidationGridSize, 0));
+  }
+ }
+
+ TArray<FVector> BakedValues;
+ TArray<FVector> AnalyticValues;
+ BakedValues.SetNumUninitialized(ValidationLocations.Num());
+ AnalyticValues.SetNumUninitialized(ValidationLocations.Num());
+
+ const float ValidationTime = AnimationPeriod * 0.5f / BakedFrameCountUsed;
+ SampleBakedWaves(ValidationLocations, ValidationTime, BakedValues);
+ EvaluateWaves(Waves, ValidationLocations, ValidationTime, AnalyticValues);
+
+ float MaxHeightError = 0;
+ for (int32 Index = 0; Index < ValidationLocations.Num(); Index++)
+ {
+  MaxHeightError = FMath::Max(MaxHeightError, FMath::Abs(BakedValues[Index].Z - AnalyticValues[Index].Z));
+ }
+
+ UE_LOG(LogTemp, Log, TEXT("%s: baked %d frames of %dx%d waves in %.2f ms, max height error %.2f"),
+  *GetName(), BakedFrameCountUsed, BakedGridSizeUsed, BakedGridSizeUsed, (FPlatformTime::Seconds() - StartTime) * 1000.0, MaxHeightError);
 }
 
-FVector AOceanManager::CalculateGerstnerWave(float wavelength, float amplitude, FVector2D position, FVector2D direction, float angle, float steepness, float time, float phase)
+void AOceanManager::SnapWavesToTile()
 {
- float lambda = (2 * PI) / wavelength;
+ // a wave only tiles if a whole number of its periods fit into the tile along both axes,
+ // so each wave vector is rounded to the nearest one that does
+ const float TileWaveNumber = (2 * PI) / BakedTileSizeUsed;
+
+ BakedWaves = Waves;
+ for (int32 i = 0; i < FOceanGerstnerWaves::NumWaves; i++)
+ {
+  float kx = FMath::RoundToFloat(Waves.WaveNumber[i] * Waves.DirectionX[i] / TileWaveNumber) * TileWaveNumber;
+  float ky = FMath::RoundToFloat(Waves.WaveNumber[i] * Waves.DirectionY[i] / TileWaveNumber) * TileWaveNumber;
 
- FVector dir = FVector(direction.X, direction.Y, 0);
- dir = dir.RotateAngleAxis(angle * 360, FVector(0, 0, 1));
+  // waves longer than the tile can't tile at all, keep them at the longest wave that does
+  if (kx == 0 && ky == 0)
+  {
+   if (FMath::Abs(Waves.DirectionX[i]) > FMath::Abs(Waves.DirectionY[i])) { kx = FMath::Sign(Waves.DirectionX[i]) * TileWaveNumber; }
+   else { ky = FMath::Sign(Waves.DirectionY[i]) * TileWaveNumber; }
+  }
 
- FVector2D rotatedDirection = FVector2D(dir.X, dir.Y);
- rotatedDirection.Normalize();
+  const float k = FMath::Sqrt(kx * kx + ky * ky);
+  const float QA = FMath::Sqrt(FMath::Square(Waves.HorizontalAmplitudeX[i]) + FMath::Square(Waves.HorizontalAmplitudeY[i]));
 
- float wavePhase = lambda * FVector2D::DotProduct(rotatedDirection, position) + (time + phase);
+  BakedWaves.DirectionX[i] = kx / k;
+  BakedWaves.DirectionY[i] = ky / k;
+  BakedWaves.WaveNumber[i] = k;
+  BakedWaves.HorizontalAmplitudeX[i] = QA * kx / k;
+  BakedWaves.HorizontalAmplitudeY[i] = QA * ky / k;
+ }
+}
+
+void AOceanManager::AddWaveCluster(int32 FirstWaveIndex, float medianWavelength, float medianAmplitude, float medianAngle, float steepness, float medianPhase)
+{
+ using namespace OceanManagerLocal;
 
- float c = FMath::Cos(wavePhase);
- float s = FMath::Sin(wavePhase);
+ // every wave is averaged within its cluster and the clusters are averaged together
+ const float AmplitudeScale = 1.f / (WavesPerCluster * NumClusters);
 
- float QA = steepness * amplitude;
+ for (int32 i = 0; i < WavesPerCluster; i++)
+ {
+  const int32 WaveIndex = FirstWaveIndex + i;
 
- return FVector(QA * rotatedDirection.X * c, QA * rotatedDirection.Y * c, amplitude * s);
-}
\ No newline at end of file
+  float wavelength = medianWavelength * WaveScales[i];
+  float amplitude = medianAmplitude * WaveScales[i] * AmplitudeScale;
+  float angle = (medianAngle + WaveAngles[i]) * 2 * PI;
+
+  float s, c;
+  FMath::SinCos(&s, &c, angle);
+  FVector2D rotatedDirection = FVector2D(Direction.X * c - Direction.Y * s, Direction.X * s + Direction.Y * c);
+  rotatedDirection.Normalize();
+
+  float QA = steepness * amplitude;
+
+  Waves.DirectionX[WaveIndex] = rotatedDirection.X;
+  Waves.DirectionY[WaveIndex] = rotatedDirection.Y;
+  Waves.WaveNumber[WaveIndex] = (2 * PI) / wavelength;
+  Waves.Phase[WaveIndex] = medianPhase + WavePhases[i];
+  Waves.HorizontalAmplitudeX[WaveIndex] = QA * rotatedDirection.X;
+  Waves.HorizontalAmplitudeY[WaveIndex] = QA * rotatedDirection.Y;
+  Waves.VerticalAmplitude[WaveIndex] = amplitude;
+ }
+}
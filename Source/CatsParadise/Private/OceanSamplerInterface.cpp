@@ -0,0 +1,47 @@
+#include "OceanSamplerInterface.h"
+
+#include "OceanManager.h"
+#include "OceanWaterZone.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarOceanSamplingBackend(
+	TEXT("ocean.SamplingBackend"),
+	0,
+	TEXT("Ocean model buoyancy is sampled from. 0: FFT water zone, 1: analytic Gerstner ocean manager"),
+	ECVF_Default);
+
+FVector IOceanSamplerInterface::GetOceanDisplacement(const FVector& Location)
+{
+	FVector Displacement = FVector::ZeroVector;
+	GetOceanDisplacements(MakeArrayView(&Location, 1), MakeArrayView(&Displacement, 1));
+	return Displacement;
+}
+
+EOceanSamplingBackend IOceanSamplerInterface::GetSamplingBackend()
+{
+	return CVarOceanSamplingBackend.GetValueOnGameThread() == 1 ? EOceanSamplingBackend::Gerstner : EOceanSamplingBackend::FFT;
+}
+
+IOceanSamplerInterface* IOceanSamplerInterface::FindOceanSampler(UWorld* World)
+{
+	if (World == nullptr) { return nullptr; }
+
+	IOceanSamplerInterface* WaterZone = nullptr;
+	for (TActorIterator<AOceanWaterZone> It(World); It && !WaterZone; ++It)
+	{
+		WaterZone = *It;
+	}
+
+	IOceanSamplerInterface* OceanManager = nullptr;
+	for (TActorIterator<AOceanManager> It(World); It && !OceanManager; ++It)
+	{
+		OceanManager = *It;
+	}
+
+	if (GetSamplingBackend() == EOceanSamplingBackend::Gerstner)
+	{
+		return OceanManager ? OceanManager : WaterZone;
+	}
+	return WaterZone ? WaterZone : OceanManager;
+}
@@ -22,6 +22,11 @@ void AOceanWaterZone::Tick(float DeltaSeconds)
     FFTCalculator.ShowDebugDisplacementPoints(GetWorld(), GetActorLocation());
 }
 
+void AOceanWaterZone::GetOceanDisplacements(TConstArrayView<FVector> Locations, TArrayView<FVector> OutDisplacements)
+{
+    FFTCalculator.GetDisplacementAtPoints(Locations, OutDisplacements);
+}
+
 bool AOceanWaterZone::ShouldTickIfViewportsOnly() const
 {
     if (GetWorld() != nullptr && GetWorld()->WorldType == EWorldType::Editor)
@@ -0,0 +1,222 @@
+#include "PackedEntityResources.h"
+#include "PackedEntityResources.ispc.generated.h"
+
+#include "EntityResourceSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Packed Resource Delta"), STAT_PackedResourceDelta, STATGROUP_EntityResource);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Packed Resources"), STAT_PackedResources, STATGROUP_EntityResource);
+
+namespace PackedEntityResourcesLocal
+{
+	uint16 ToPacked(int32 Value)
+	{
+		return static_cast<uint16>(FMath::Clamp(Value, 0, static_cast<int32>(MAX_uint16)));
+	}
+}
+
+int32 FPackedEntityResources::AddArchetype(const FPackedResourceArchetype& Archetype)
+{
+	if(Archetypes.Num() > MAX_uint16)
+	{
+		UE_LOG(LogTemp, Error, TEXT("FPackedEntityResources::AddArchetype: too many archetypes"));
+		return INDEX_NONE;
+	}
+
+	return Archetypes.Add(Archetype);
+}
+
+FPackedResourceHandle FPackedEntityResources::Add(int32 ArchetypeIndex)
+{
+	if(!Archetypes.IsValidIndex(ArchetypeIndex))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FPackedEntityResources::Add: invalid archetype %d"), ArchetypeIndex);
+		return FPackedResourceHandle();
+	}
+
+	int32 Index;
+	if(FreeIndices.IsEmpty())
+	{
+		Index = Values.AddZeroed();
+		MaxValues.AddZeroed();
+		ArchetypeIndices.AddZeroed();
+		Generations.AddZeroed();
+	}
+	else
+	{
+		Index = FreeIndices.Pop(false);
+	}
+
+	ArchetypeIndices[Index] = static_cast<uint16>(ArchetypeIndex);
+	const FPackedResourceHandle Handle = MakeHandle(Index);
+	ResetToArchetype(Handle);
+
+	SET_DWORD_STAT(STAT_PackedResources, Num());
+	return Handle;
+}
+
+void FPackedEntityResources::Remove(FPackedResourceHandle Handle)
+{
+	if(!IsValidIndex(Handle))
+	{
+		return;
+	}
+
+	// zeroed resources are skipped by the bulk passes without a branch, bumping the generation makes the handles stale
+	Values[Handle.Index] = 0;
+	MaxValues[Handle.Index] = 0;
+	Generations[Handle.Index]++;
+	FreeIndices.Add(Handle.Index);
+
+	SET_DWORD_STAT(STAT_PackedResources, Num());
+}
+
+bool FPackedEntityResources::IsValidHandle(FPackedResourceHandle Handle) const
+{
+	return IsValidIndex(Handle);
+}
+
+int32 FPackedEntityResources::GetValue(FPackedResourceHandle Handle) const
+{
+	return IsValidIndex(Handle) ? Values[Handle.Index] : 0;
+}
+
+int32 FPackedEntityResources::GetMaxValue(FPackedResourceHandle Handle) const
+{
+	return IsValidIndex(Handle) ? MaxValues[Handle.Index] : 0;
+}
+
+void FPackedEntityResources::SetValue(FPackedResourceHandle Handle, int32 Value)
+{
+	if(IsValidIndex(Handle))
+	{
+		Values[Handle.Index] = PackedEntityResourcesLocal::ToPacked(Value);
+	}
+}
+
+void FPackedEntityResources::SetMaxValue(FPackedResourceHandle Handle, int32 MaxValue)
+{
+	if(IsValidIndex(Handle))
+	{
+		MaxValues[Handle.Index] = PackedEntityResourcesLocal::ToPacked(MaxValue);
+	}
+}
+
+void FPackedEntityResources::ResetToArchetype(FPackedResourceHandle Handle)
+{
+	if(!IsValidIndex(Handle))
+	{
+		return;
+	}
+
+	const FPackedResourceArchetype& Archetype = Archetypes[ArchetypeIndices[Handle.Index]];
+	MaxValues[Handle.Index] = PackedEntityResourcesLocal::ToPacked(Archetype.MaxValue);
+	Values[Handle.Index] = PackedEntityResourcesLocal::ToPacked(Archetype.bUseCustomInitialValue ? Archetype.InitialValue : Archetype.MaxValue);
+}
+
+int32 FPackedEntityResources::ApplyDeltaToAll(int32 Delta, TArray<FPackedResourceHandle>* OutDepleted)
+{
+	if(Delta == 0 || Values.IsEmpty())
+	{
+		return 0;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_PackedResourceDelta);
+
+	DepletedIndices.SetNumUninitialized(Values.Num());
+	int32 NumDepleted = 0;
+	const int32 NumChanged = ispc::FPackedResource_ApplyDelta(
+		Delta,
+		Values.GetData(),
+		MaxValues.GetData(),
+		DepletedIndices.GetData(),
+		NumDepleted,
+		Values.Num());
+
+	if(OutDepleted)
+	{
+		OutDepleted->Reserve(OutDepleted->Num() + NumDepleted);
+		for(int32 Index = 0; Index < NumDepleted; Index++)
+		{
+			OutDepleted->Add(MakeHandle(DepletedIndices[Index]));
+		}
+	}
+
+	return NumChanged;
+}
+
+int32 FPackedEntityResources::ApplyDelta(TConstArrayView<FPackedResourceHandle> Handles, int32 Delta, TArray<FPackedResourceHandle>* OutDepleted)
+{
+	if(Delta == 0)
+	{
+		return 0;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_PackedResourceDelta);
+
+	int32 NumChanged = 0;
+	for(const FPackedResourceHandle& Handle : Handles)
+	{
+		if(!IsValidIndex(Handle))
+		{
+			continue;
+		}
+
+		const int32 Value = Values[Handle.Index];
+		const int32 NewValue = FMath::Clamp(Value + Delta, 0, FMath::Max<int32>(MaxValues[Handle.Index], Value));
+		if(NewValue == Value)
+		{
+			continue;
+		}
+
+		Values[Handle.Index] = static_cast<uint16>(NewValue);
+		NumChanged++;
+		if(NewValue == 0 && OutDepleted)
+		{
+			OutDepleted->Add(Handle);
+		}
+	}
+
+	return NumChanged;
+}
+
+int32 FPackedEntityResources::Num() const
+{
+	return Values.Num() - FreeIndices.Num();
+}
+
+SIZE_T FPackedEntityResources::GetAllocatedSize() const
+{
+	return Archetypes.GetAllocatedSize()
+		+ Values.GetAllocatedSize()
+		+ MaxValues.GetAllocatedSize()
+		+ ArchetypeIndices.GetAllocatedSize()
+		+ Generations.GetAllocatedSize()
+		+ FreeIndices.GetAllocatedSize()
+		+ DepletedIndices.GetAllocatedSize();
+}
+
+void FPackedEntityResources::Reset()
+{
+	Archetypes.Empty();
+	Values.Empty();
+	MaxValues.Empty();
+	ArchetypeIndices.Empty();
+	Generations.Empty();
+	FreeIndices.Empty();
+	DepletedIndices.Empty();
+
+	SET_DWORD_STAT(STAT_PackedResources, 0);
+}
+
+bool FPackedEntityResources::IsValidIndex(FPackedResourceHandle Handle) const
+{
+	return Generations.IsValidIndex(Handle.Index) && Generations[Handle.Index] == Handle.Generation;
+}
+
+FPackedResourceHandle FPackedEntityResources::MakeHandle(int32 Index) const
+{
+	FPackedResourceHandle Handle;
+	Handle.Index = Index;
+	Handle.Generation = Generations[Index];
+	return Handle;
+}
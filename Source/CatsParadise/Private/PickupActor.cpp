@@ -3,12 +3,16 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InteractionComponent.h"
+#include "InteractionGridSubsystem.h"
 #include "ItemInterface.h"
 #include "CatsParadiseCharacter.h"
+#include "PickupDropSubsystem.h"
+#include "PickupPoolSubsystem.h"
 
 APickupActor::APickupActor()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
+	NetDormancy = DORM_Initial;
 
 	PickupRootComponent = CreateDefaultSubobject<USceneComponent>("RootComponent");
 	SetRootComponent(ToRawPtr(PickupRootComponent));
@@ -16,6 +20,8 @@ APickupActor::APickupActor()
 	InteractionTriggerComponent = CreateDefaultSubobject<UInteractionComponent>("InteractionTrigger");
 	InteractionTriggerComponent->SetupAttachment(GetRootComponent());
 	UInteractionComponent::SetTriggerDefaultCollision(InteractionTriggerComponent);
+	// found through the interaction grid, so idle pickups can go dormant
+	InteractionTriggerComponent->Discovery = EInteractionDiscovery::SpatialHash;
 }
 
 void APickupActor::OnConstruction(const FTransform& Transform)
@@ -33,11 +39,13 @@ void APickupActor::BeginPlay()
 	Super::BeginPlay();
 
 	InteractionTriggerComponent->SetInteractionData(InteractionData);
-}
-
-void APickupActor::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
+	InteractionTriggerComponent->OnDormancyChanged.AddDynamic(this, &APickupActor::HandleTriggerDormancyChanged);
+	if (InteractionTriggerComponent->IsDormant())
+	{
+		// the trigger registered with the grid before the delegate was bound
+		HandleTriggerDormancyChanged(true);
+	}
+	bNativeUseItem = !FInteractionDispatch::HasBlueprintOverride(GetClass(), GET_FUNCTION_NAME_CHECKED(IItemInterface, UseItem));
 }
 
 bool APickupActor::ActivatePickup(ACatsParadiseBaseCharacter* OtherActor)
@@ -53,7 +61,7 @@ bool APickupActor::ActivatePickup(ACatsParadiseBaseCharacter* OtherActor)
 
 	if (bDestroyOnActivation)
 	{
-		Destroy();
+		RemoveActivatedPickup();
 	}
 	else
 	{
@@ -77,7 +85,7 @@ bool APickupActor::TakePickupItem(ACatsParadiseBaseCharacter* OtherActor)
 
 	if (bDestroyOnActivation)
 	{
-		Destroy();
+		RemoveActivatedPickup();
 	}
 	else
 	{
@@ -97,6 +105,7 @@ void APickupActor::EnablePickup()
 
 	//SetActorHiddenInGame(false);
 	SetActorEnableCollision(true);
+	RefreshInteractionGrid();
 
 	OnPickupEnabled();
 }
@@ -110,10 +119,96 @@ void APickupActor::DisablePickup()
 
 	//SetActorHiddenInGame(true);
 	SetActorEnableCollision(false);
+	RefreshInteractionGrid();
 
 	OnPickupDisabled();
 }
 
+void APickupActor::RefreshInteractionGrid()
+{
+	// the grid filters disabled pickups out, but seekers standing still only query again when told to
+	if(UInteractionGridSubsystem* GridSubsystem = UWorld::GetSubsystem<UInteractionGridSubsystem>(GetWorld()))
+	{
+		GridSubsystem->RefreshInteractable(InteractionTriggerComponent);
+	}
+}
+
+bool APickupActor::IsDormant() const
+{
+	return InteractionTriggerComponent && InteractionTriggerComponent->IsDormant();
+}
+
+bool APickupActor::IsPooled() const
+{
+	return bPooled;
+}
+
+void APickupActor::OnAcquiredFromPool(const FTransform& Transform)
+{
+	bPooled = false;
+
+	const APickupActor* Defaults = GetClass()->GetDefaultObject<APickupActor>();
+	InteractionData = Defaults->InteractionData;
+	InteractionTriggerComponent->SetInteractionData(InteractionData);
+	bCanUse = Defaults->bCanUse;
+
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	DefaultTransform = Transform;
+
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(PrimaryActorTick.bStartWithTickEnabled);
+	EnablePickup();
+}
+
+void APickupActor::OnReleasedToPool()
+{
+	bPooled = true;
+	CancelDrop();
+
+	if (GetAttachParentActor())
+	{
+		DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	}
+	TargetActor = nullptr;
+
+	DisablePickup();
+	SetActorHiddenInGame(true);
+	SetActorTickEnabled(false);
+}
+
+void APickupActor::HandleTriggerDormancyChanged(bool bIsDormant)
+{
+	// Blueprint pickups may still tick, they don't while nobody is around
+	if (!bPooled)
+	{
+		SetActorTickEnabled(!bIsDormant && PrimaryActorTick.bStartWithTickEnabled);
+	}
+
+	if (HasAuthority())
+	{
+		SetNetDormancy(bIsDormant ? DORM_DormantAll : DORM_Awake);
+	}
+}
+
+void APickupActor::CancelDrop()
+{
+	if (UPickupDropSubsystem* DropSubsystem = UWorld::GetSubsystem<UPickupDropSubsystem>(GetWorld()))
+	{
+		DropSubsystem->CancelDrop(this);
+	}
+}
+
+void APickupActor::RemoveActivatedPickup()
+{
+	UPickupPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<UPickupPoolSubsystem>(GetWorld());
+	if (bReturnToPool && PoolSubsystem && PoolSubsystem->ReleasePickup(this))
+	{
+		return;
+	}
+
+	Destroy();
+}
+
 FInteractionData APickupActor::GetInteractionData() const
 {
 	return InteractionData;
@@ -156,6 +251,8 @@ void APickupActor::AttachItem()
 		return;
 	}
 	
+	CancelDrop();
+
 	// Attach the item to the First Person Character
 	FAttachmentTransformRules AttachmentRules(EAttachmentRule::SnapToTarget, true);
 	AttachToComponent(TargetActor->GetCharacterMesh(), AttachmentRules, FName(TEXT("GripPoint")));
@@ -177,12 +274,20 @@ void APickupActor::DetachItem()
 	SetActorRotation(FRotator::ZeroRotator);
 
 	TargetActor->ResetItem();
-	
-	FHitResult HitResult = GetFloor();
-	if(IsValid(HitResult.GetActor()))
+
+	// batched with the other drops of the frame, the pickup lands on the floor or the water a couple of frames later
+	if(UPickupDropSubsystem* DropSubsystem = UWorld::GetSubsystem<UPickupDropSubsystem>(GetWorld()))
 	{
-		UE_LOG(LogTemp, Display, TEXT("Trace Floor: %s"), *HitResult.GetActor()->GetFName().ToString());
-		SetActorLocation(HitResult.Location);
+		DropSubsystem->RequestDrop(this, SightDistance, TraceChannel, {GetOwner(), TargetActor});
+	}
+	else
+	{
+		FHitResult HitResult = GetFloor();
+		if(IsValid(HitResult.GetActor()))
+		{
+			UE_LOG(LogTemp, Display, TEXT("Trace Floor: %s"), *HitResult.GetActor()->GetFName().ToString());
+			SetActorLocation(HitResult.Location);
+		}
 	}
 	
 	TargetActor = nullptr;
@@ -199,6 +304,7 @@ void APickupActor::DropItem()
 	DetachItem();
 	if(bReturnOnDefaultLocation)
 	{
+		CancelDrop();
 		SetActorTransform(DefaultTransform);
 	}
 }
@@ -210,13 +316,14 @@ void APickupActor::TryUseItem()
 		return;
 	}
 
-	bool bIsSuccess = Execute_UseItem(this);
+	bool bIsSuccess = bNativeUseItem ? UseItem_Implementation() : Execute_UseItem(this);
 	OnUseItem.Broadcast(this, bIsSuccess);
 }
 
 bool APickupActor::HasItemInterface()
 {
-	return GetClass()->ImplementsInterface(UItemInterface::StaticClass());
+	// implemented natively, so every pickup class has it
+	return true;
 }
 
 void APickupActor::SetCurrentTransformByDefault()
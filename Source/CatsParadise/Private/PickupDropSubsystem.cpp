@@ -0,0 +1,261 @@
+#include "PickupDropSubsystem.h"
+
+#include "PickupActor.h"
+#include "PlayerFocusSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Drop Traces"), STAT_PickupDropTraces, STATGROUP_Interaction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floating Pickups"), STAT_PickupFloating, STATGROUP_Interaction);
+
+static TAutoConsoleVariable<float> CVarPickupDropWaterDepth(
+	TEXT("pickup.DropWaterDepth"),
+	500.f,
+	TEXT("How far in centimeters below the ocean plane drop traces reach, a drop finding no floor down to there is over water"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarPickupFloatUpdateThreshold(
+	TEXT("pickup.FloatUpdateThreshold"),
+	0.5f,
+	TEXT("How far in centimeters the water surface under a floating pickup moves before the pickup is moved along"),
+	ECVF_Default);
+
+void UPickupDropSubsystem::Deinitialize()
+{
+	QueuedDrops.Empty();
+	TracedDrops.Empty();
+	FloatingPickups.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UPickupDropSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPickupDropSubsystem, STATGROUP_Tickables);
+}
+
+void UPickupDropSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// last tick's traces are resolved before new ones are issued, async results only stay around for a frame
+	ResolveTracedDrops();
+	TraceQueuedDrops();
+	UpdateFloatingPickups();
+}
+
+void UPickupDropSubsystem::RequestDrop(APickupActor* Pickup, float TraceDistance, ETraceTypeQuery TraceChannel, const TArray<const AActor*>& IgnoredActors)
+{
+	if(!IsValid(Pickup))
+	{
+		return;
+	}
+
+	CancelDrop(Pickup);
+
+	FDropRequest& Request = QueuedDrops.AddDefaulted_GetRef();
+	Request.Pickup = Pickup;
+	Request.TraceStart = Pickup->GetActorLocation();
+	Request.TraceEnd = Request.TraceStart - FVector::UpVector * TraceDistance;
+	Request.FloorDistance = TraceDistance;
+	Request.TraceChannel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+	Request.IgnoredActors.Append(IgnoredActors);
+}
+
+void UPickupDropSubsystem::CancelDrop(const APickupActor* Pickup)
+{
+	auto IsPickup = [Pickup](const FDropRequest& Request) { return Request.Pickup == Pickup; };
+	QueuedDrops.RemoveAllSwap(IsPickup);
+	TracedDrops.RemoveAllSwap(IsPickup);
+	FloatingPickups.RemoveAllSwap([Pickup](const TWeakObjectPtr<APickupActor>& Other) { return Other == Pickup; });
+}
+
+bool UPickupDropSubsystem::IsFloating(const APickupActor* Pickup) const
+{
+	return FloatingPickups.ContainsByPredicate([Pickup](const TWeakObjectPtr<APickupActor>& Other) { return Other == Pickup; });
+}
+
+IOceanSamplerInterface* UPickupDropSubsystem::UpdateOceanSampler()
+{
+	// looked up again when the backend is switched at runtime or the ocean it found was destroyed,
+	// a world without any ocean isn't searched again every tick
+	const EOceanSamplingBackend Backend = IOceanSamplerInterface::GetSamplingBackend();
+	if(bOceanSamplerSearched && Backend == OceanSamplerBackend && !OceanSampler.IsStale())
+	{
+		return OceanSampler.Get();
+	}
+
+	OceanSamplerBackend = Backend;
+	OceanSampler = IOceanSamplerInterface::FindOceanSampler(GetWorld());
+	bOceanSamplerSearched = true;
+	return OceanSampler.Get();
+}
+
+void UPickupDropSubsystem::TraceQueuedDrops()
+{
+	// the ocean plane is at zero, reaching below it tells drops over water from drops too high above the floor
+	const bool bTraceToWater = !QueuedDrops.IsEmpty() && UpdateOceanSampler() != nullptr;
+	const double WaterTraceEnd = -CVarPickupDropWaterDepth.GetValueOnGameThread();
+
+	for(FDropRequest& Request : QueuedDrops)
+	{
+		if(!Request.Pickup.IsValid())
+		{
+			continue;
+		}
+
+		Request.bTracedToWater = bTraceToWater;
+		if(bTraceToWater)
+		{
+			Request.TraceEnd.Z = FMath::Min(Request.TraceEnd.Z, WaterTraceEnd);
+		}
+
+		INC_DWORD_STAT(STAT_PickupDropTraces);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PickupDrop), false, Request.Pickup.Get());
+		for(const TWeakObjectPtr<const AActor>& IgnoredActor : Request.IgnoredActors)
+		{
+			if(IgnoredActor.IsValid())
+			{
+				QueryParams.AddIgnoredActor(IgnoredActor.Get());
+			}
+		}
+
+		Request.Trace = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Request.TraceStart, Request.TraceEnd,
+			Request.TraceChannel, QueryParams);
+		TracedDrops.Add(MoveTemp(Request));
+	}
+
+	QueuedDrops.Reset();
+}
+
+void UPickupDropSubsystem::ResolveTracedDrops()
+{
+	if(TracedDrops.IsEmpty())
+	{
+		return;
+	}
+
+	IOceanSamplerInterface* Sampler = UpdateOceanSampler();
+
+	struct FResolvedDrop
+	{
+		APickupActor* Pickup = nullptr;
+		FVector Location = FVector::ZeroVector;
+		bool bHit = false;
+		bool bWithinFloorDistance = false;
+		bool bTracedToWater = false;
+	};
+	TArray<FResolvedDrop, TInlineAllocator<32>> ResolvedDrops;
+
+	for(int32 Index = TracedDrops.Num() - 1; Index >= 0; Index--)
+	{
+		FDropRequest& Request = TracedDrops[Index];
+		APickupActor* Pickup = Request.Pickup.Get();
+
+		FTraceDatum TraceDatum;
+		if(!IsValid(Pickup))
+		{
+			TracedDrops.RemoveAtSwap(Index);
+		}
+		else if(GetWorld()->QueryTraceData(Request.Trace, TraceDatum))
+		{
+			const FHitResult* Hit = TraceDatum.OutHits.FindByPredicate([](const FHitResult& HitResult) { return HitResult.bBlockingHit; });
+			const bool bWithinFloorDistance = Hit && Request.TraceStart.Z - Hit->Location.Z <= Request.FloorDistance;
+			ResolvedDrops.Add({Pickup, Hit ? FVector(Hit->Location) : Request.TraceStart, Hit != nullptr, bWithinFloorDistance, Request.bTracedToWater});
+			TracedDrops.RemoveAtSwap(Index);
+		}
+		else if(!GetWorld()->IsTraceHandleValid(Request.Trace, false))
+		{
+			// the result was missed, trace it again
+			Request.Trace = FTraceHandle();
+			QueuedDrops.Add(MoveTemp(Request));
+			TracedDrops.RemoveAtSwap(Index);
+		}
+	}
+
+	if(ResolvedDrops.IsEmpty())
+	{
+		return;
+	}
+
+	// the ocean is sampled once for every drop that arrived this tick
+	if(Sampler)
+	{
+		SampleLocations.Reset(ResolvedDrops.Num());
+		for(const FResolvedDrop& Drop : ResolvedDrops)
+		{
+			SampleLocations.Add(FVector(Drop.Location.X, Drop.Location.Y, 0.0));
+		}
+		SampleDisplacements.SetNumUninitialized(SampleLocations.Num());
+		Sampler->GetOceanDisplacements(SampleLocations, SampleDisplacements);
+	}
+
+	for(int32 Index = 0; Index < ResolvedDrops.Num(); Index++)
+	{
+		const FResolvedDrop& Drop = ResolvedDrops[Index];
+		const double WaterHeight = Sampler ? SampleDisplacements[Index].Z : -UE_BIG_NUMBER;
+
+		// the trace reached below the ocean plane, missing means deep water and a floor under the surface is sunk
+		if(Sampler && ((!Drop.bHit && Drop.bTracedToWater) || (Drop.bHit && Drop.Location.Z < WaterHeight)))
+		{
+			Drop.Pickup->SetActorLocation(FVector(Drop.Location.X, Drop.Location.Y, WaterHeight));
+			FloatingPickups.AddUnique(Drop.Pickup);
+		}
+		else if(Drop.bWithinFloorDistance)
+		{
+			Drop.Pickup->SetActorLocation(Drop.Location);
+		}
+	}
+}
+
+void UPickupDropSubsystem::UpdateFloatingPickups()
+{
+	FloatingPickups.RemoveAllSwap([this](const TWeakObjectPtr<APickupActor>& Pickup) { return !CanFloat(Pickup.Get()); });
+	SET_DWORD_STAT(STAT_PickupFloating, FloatingPickups.Num());
+
+	IOceanSamplerInterface* Sampler = FloatingPickups.IsEmpty() ? nullptr : UpdateOceanSampler();
+	if(!Sampler)
+	{
+		return;
+	}
+
+	// nobody is near dormant pickups to see them bob, they catch up with the surface once they wake
+	SampledPickups.Reset(FloatingPickups.Num());
+	SampleLocations.Reset(FloatingPickups.Num());
+	for(const TWeakObjectPtr<APickupActor>& Pickup : FloatingPickups)
+	{
+		if(!Pickup->IsDormant())
+		{
+			const FVector Location = Pickup->GetActorLocation();
+			SampledPickups.Add(Pickup.Get());
+			SampleLocations.Add(FVector(Location.X, Location.Y, 0.0));
+		}
+	}
+
+	if(SampledPickups.IsEmpty())
+	{
+		return;
+	}
+
+	SampleDisplacements.SetNumUninitialized(SampleLocations.Num());
+	Sampler->GetOceanDisplacements(SampleLocations, SampleDisplacements);
+
+	// every move updates the trigger and the interaction grid, small ripples aren't worth it
+	const float UpdateThreshold = CVarPickupFloatUpdateThreshold.GetValueOnGameThread();
+	for(int32 Index = 0; Index < SampledPickups.Num(); Index++)
+	{
+		APickupActor* Pickup = SampledPickups[Index];
+		const double WaterHeight = SampleDisplacements[Index].Z;
+		if(FMath::Abs(Pickup->GetActorLocation().Z - WaterHeight) > UpdateThreshold)
+		{
+			Pickup->SetActorLocation(FVector(SampleLocations[Index].X, SampleLocations[Index].Y, WaterHeight));
+		}
+	}
+}
+
+bool UPickupDropSubsystem::CanFloat(const APickupActor* Pickup) const
+{
+	// picked up, pooled or moved somewhere else by gameplay
+	return IsValid(Pickup) && !Pickup->IsPooled() && !Pickup->GetAttachParentActor();
+}
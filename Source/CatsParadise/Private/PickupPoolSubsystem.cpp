@@ -0,0 +1,95 @@
+#include "PickupPoolSubsystem.h"
+
+#include "PickupActor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarPickupPoolMaxSize(
+	TEXT("pickup.PoolMaxSize"),
+	64,
+	TEXT("How many pickups of one class are kept pooled, released pickups over it are destroyed"),
+	ECVF_Default);
+
+void UPickupPoolSubsystem::Deinitialize()
+{
+	PooledPickups.Empty();
+
+	Super::Deinitialize();
+}
+
+void UPickupPoolSubsystem::PrewarmPickups(TSubclassOf<APickupActor> PickupClass, int32 Count)
+{
+	if(!PickupClass)
+	{
+		return;
+	}
+
+	Count = FMath::Min(Count, CVarPickupPoolMaxSize.GetValueOnGameThread());
+	for(int32 Index = GetNumPooledPickups(PickupClass); Index < Count; Index++)
+	{
+		APickupActor* Pickup = SpawnPickup(PickupClass, FTransform::Identity);
+		if(!Pickup || !ReleasePickup(Pickup))
+		{
+			return;
+		}
+	}
+}
+
+APickupActor* UPickupPoolSubsystem::AcquirePickup(TSubclassOf<APickupActor> PickupClass, const FTransform& Transform)
+{
+	if(!PickupClass)
+	{
+		return nullptr;
+	}
+
+	if(TArray<TWeakObjectPtr<APickupActor>>* Pool = PooledPickups.Find(PickupClass))
+	{
+		while(!Pool->IsEmpty())
+		{
+			APickupActor* Pickup = Pool->Pop(false).Get();
+			if(IsValid(Pickup))
+			{
+				Pickup->OnAcquiredFromPool(Transform);
+				return Pickup;
+			}
+		}
+	}
+
+	return SpawnPickup(PickupClass, Transform);
+}
+
+bool UPickupPoolSubsystem::ReleasePickup(APickupActor* Pickup)
+{
+	if(!IsValid(Pickup) || Pickup->IsPooled())
+	{
+		return false;
+	}
+
+	TArray<TWeakObjectPtr<APickupActor>>& Pool = PooledPickups.FindOrAdd(Pickup->GetClass());
+	if(Pool.Num() >= CVarPickupPoolMaxSize.GetValueOnGameThread())
+	{
+		return false;
+	}
+
+	Pickup->OnReleasedToPool();
+	Pool.Add(Pickup);
+	return true;
+}
+
+int32 UPickupPoolSubsystem::GetNumPooledPickups(TSubclassOf<APickupActor> PickupClass) const
+{
+	const TArray<TWeakObjectPtr<APickupActor>>* Pool = PooledPickups.Find(PickupClass);
+	return Pool ? Pool->Num() : 0;
+}
+
+APickupActor* UPickupPoolSubsystem::SpawnPickup(TSubclassOf<APickupActor> PickupClass, const FTransform& Transform) const
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	APickupActor* Pickup = GetWorld()->SpawnActor<APickupActor>(PickupClass, Transform, SpawnParameters);
+	if(Pickup)
+	{
+		Pickup->SetDefaultTransform(Transform);
+	}
+	return Pickup;
+}
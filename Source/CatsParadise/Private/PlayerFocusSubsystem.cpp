@@ -0,0 +1,205 @@
+#include "PlayerFocusSubsystem.h"
+
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Focus Traces"), STAT_PlayerFocusTraces, STATGROUP_Interaction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Focus Reuses"), STAT_PlayerFocusReuses, STATGROUP_Interaction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("View Point Hits"), STAT_PlayerViewPointHits, STATGROUP_Interaction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("View Point Misses"), STAT_PlayerViewPointMisses, STATGROUP_Interaction);
+
+static TAutoConsoleVariable<float> CVarFocusLocationTolerance(
+	TEXT("interaction.FocusLocationTolerance"),
+	1.f,
+	TEXT("How far in centimeters a view can move before its focus is traced again"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFocusAngleTolerance(
+	TEXT("interaction.FocusAngleTolerance"),
+	0.25f,
+	TEXT("How far in degrees a view can turn before its focus is traced again"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFocusMaxAge(
+	TEXT("interaction.FocusMaxAge"),
+	0.2f,
+	TEXT("Seconds a focus result is reused for a still view, so actors moving through the view are still caught"),
+	ECVF_Default);
+
+void UPlayerFocusSubsystem::Deinitialize()
+{
+	FocusEntries.Empty();
+	ViewPoints.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UPlayerFocusSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPlayerFocusSubsystem, STATGROUP_Tickables);
+}
+
+void UPlayerFocusSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// async results only stay around for a frame, so they are collected here rather than when asked for
+	for(TPair<TObjectKey<AActor>, TArray<FFocusEntry, TInlineAllocator<2>>>& Pair : FocusEntries)
+	{
+		for(FFocusEntry& Entry : Pair.Value)
+		{
+			if(Entry.PendingTrace.IsValid())
+			{
+				ReceiveTrace(Entry);
+			}
+		}
+	}
+}
+
+AActor* UPlayerFocusSubsystem::GetFocusedActor(const AActor* Viewer, const FVector& ViewLocation, const FRotator& ViewRotation, const FPlayerFocusTraceSettings& Settings, uint32 InvalidationKey)
+{
+	if(!IsValid(Viewer))
+	{
+		return nullptr;
+	}
+
+	const FQuat ViewQuat = ViewRotation.Quaternion();
+	TArray<FFocusEntry, TInlineAllocator<2>>& Entries = FocusEntries.FindOrAdd(Viewer);
+
+	FFocusEntry* Entry = Entries.FindByPredicate([&](const FFocusEntry& Other) { return Other.Settings.MatchesTrace(Settings); });
+	if(!Entry)
+	{
+		Entry = &Entries.AddDefaulted_GetRef();
+		Entry->Settings = Settings;
+	}
+	else if(Entry->PendingTrace.IsValid() || IsEntryValid(*Entry, ViewLocation, ViewQuat, InvalidationKey))
+	{
+		INC_DWORD_STAT(STAT_PlayerFocusReuses);
+		return Entry->FocusedActor.Get();
+	}
+
+	INC_DWORD_STAT(STAT_PlayerFocusTraces);
+
+	Entry->Settings = Settings;
+	Entry->ViewLocation = ViewLocation;
+	Entry->ViewRotation = ViewQuat;
+	if(InvalidationKey != 0)
+	{
+		Entry->InvalidationKey = InvalidationKey;
+	}
+	Entry->TraceTime = GetWorld()->GetTimeSeconds();
+	Entry->PendingTrace = RequestTrace(Viewer, ViewLocation, ViewRotation, Settings);
+	return Entry->FocusedActor.Get();
+}
+
+void UPlayerFocusSubsystem::GetPlayerViewPoint(const APlayerController* Controller, FVector& OutLocation, FRotator& OutRotation)
+{
+	if(!IsValid(Controller))
+	{
+		return;
+	}
+
+	// the camera only updates after the tick groups, so the view point is the same for the whole frame
+	if(ViewPointsFrame != GFrameCounter)
+	{
+		ViewPoints.Reset();
+		ViewPointsFrame = GFrameCounter;
+	}
+
+	if(const FViewPoint* ViewPoint = ViewPoints.Find(Controller))
+	{
+		INC_DWORD_STAT(STAT_PlayerViewPointHits);
+		OutLocation = ViewPoint->Location;
+		OutRotation = ViewPoint->Rotation;
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_PlayerViewPointMisses);
+	Controller->GetPlayerViewPoint(OutLocation, OutRotation);
+	ViewPoints.Add(Controller, FViewPoint{OutLocation, OutRotation});
+}
+
+void UPlayerFocusSubsystem::RemoveViewer(const AActor* Viewer)
+{
+	FocusEntries.Remove(Viewer);
+}
+
+bool UPlayerFocusSubsystem::IsEntryValid(const FFocusEntry& Entry, const FVector& ViewLocation, const FQuat& ViewRotation, uint32 InvalidationKey) const
+{
+	if(Entry.TraceTime < 0.0 || (InvalidationKey != 0 && Entry.InvalidationKey != InvalidationKey))
+	{
+		return false;
+	}
+
+	// a focused actor that went away has to be replaced by whatever is behind it
+	if(Entry.FocusedActor.IsStale())
+	{
+		return false;
+	}
+
+	if(GetWorld()->GetTimeSeconds() - Entry.TraceTime > CVarFocusMaxAge.GetValueOnGameThread())
+	{
+		return false;
+	}
+
+	return FVector::DistSquared(Entry.ViewLocation, ViewLocation) <= FMath::Square(CVarFocusLocationTolerance.GetValueOnGameThread())
+		&& Entry.ViewRotation.AngularDistance(ViewRotation) <= FMath::DegreesToRadians(CVarFocusAngleTolerance.GetValueOnGameThread());
+}
+
+FTraceHandle UPlayerFocusSubsystem::RequestTrace(const AActor* Viewer, const FVector& ViewLocation, const FRotator& ViewRotation, const FPlayerFocusTraceSettings& Settings) const
+{
+	const FVector TraceStart {ViewLocation};
+	const FVector TraceEnd {TraceStart + ViewRotation.Vector() * Settings.Distance};
+	const ECollisionChannel CollisionChannel = UEngineTypes::ConvertToCollisionChannel(Settings.TraceChannel);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PlayerFocus), false, Viewer);
+
+	if(Settings.Radius <= 0.f)
+	{
+		return GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, CollisionChannel, QueryParams);
+	}
+
+	return GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, FQuat::Identity, CollisionChannel,
+		FCollisionShape::MakeSphere(Settings.Radius), QueryParams);
+}
+
+void UPlayerFocusSubsystem::ReceiveTrace(FFocusEntry& Entry)
+{
+	FTraceDatum TraceDatum;
+	if(GetWorld()->QueryTraceData(Entry.PendingTrace, TraceDatum))
+	{
+		Entry.FocusedActor = TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0].GetActor() : nullptr;
+		Entry.PendingTrace.Invalidate();
+		DrawDebugTrace(Entry.Settings, TraceDatum);
+	}
+	else if(!GetWorld()->IsTraceHandleValid(Entry.PendingTrace, false))
+	{
+		// the result was missed, trace again on the next request
+		Entry.PendingTrace.Invalidate();
+		Entry.TraceTime = -1.0;
+	}
+}
+
+void UPlayerFocusSubsystem::DrawDebugTrace(const FPlayerFocusTraceSettings& Settings, const FTraceDatum& TraceDatum) const
+{
+	if(Settings.DebugTrace == EDrawDebugTrace::None)
+	{
+		return;
+	}
+
+	const bool bPersistent = Settings.DebugTrace == EDrawDebugTrace::Persistent;
+	const float LifeTime = Settings.DebugTrace == EDrawDebugTrace::ForDuration ? Settings.DebugDrawTime : 0.f;
+
+	if(TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit)
+	{
+		const FVector ImpactLocation = Settings.Radius > 0.f ? TraceDatum.OutHits[0].Location : TraceDatum.OutHits[0].ImpactPoint;
+		DrawDebugLine(GetWorld(), TraceDatum.Start, ImpactLocation, FColor::Red, bPersistent, LifeTime);
+		DrawDebugLine(GetWorld(), ImpactLocation, TraceDatum.End, FColor::Green, bPersistent, LifeTime);
+		DrawDebugPoint(GetWorld(), TraceDatum.OutHits[0].ImpactPoint, 16.f, FColor::Red, bPersistent, LifeTime);
+	}
+	else
+	{
+		DrawDebugLine(GetWorld(), TraceDatum.Start, TraceDatum.End, FColor::Red, bPersistent, LifeTime);
+	}
+}
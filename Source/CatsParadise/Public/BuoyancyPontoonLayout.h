@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Pontoon geometry preprocessed once, so orienting a floating object from the
+ * heights sampled under its pontoons is a few dot products instead of a chain of slerps.
+ * The heights are fitted with the least squares plane Z = A * X + B * Y + C,
+ * where X and Y are the pontoon coordinates relative to the pontoon centroid.
+ */
+struct CATSPARADISE_API FBuoyancyPontoonLayout
+{
+public:
+
+	void Initialize(TConstArrayView<FVector> PontoonLocations);
+
+	/** False if there are less than three pontoons or they are all on one line. */
+	bool IsValid() const { return bValid; }
+	int32 Num() const { return NumPontoons; }
+	const FVector& GetCentroid() const { return Centroid; }
+
+	/**
+	 * Fits the plane through Heights, sampled under each pontoon in the order passed to Initialize.
+	 * Returns (A, B, C), C being the plane height at the centroid.
+	 */
+	FVector SolvePlane(TConstArrayView<float> Heights) const;
+
+	/** Rotation tilting the up vector onto the normal of a plane returned by SolvePlane. */
+	static FQuat GetPlaneRotation(const FVector& Plane);
+
+private:
+
+	int32 NumPontoons = 0;
+	bool bValid = false;
+	FVector Centroid = FVector::ZeroVector;
+
+	// Per pontoon weights of the closed form solve, A = dot(WeightsA, Heights) and so on
+	TArray<float> WeightsA;
+	TArray<float> WeightsB;
+	TArray<float> WeightsC;
+};
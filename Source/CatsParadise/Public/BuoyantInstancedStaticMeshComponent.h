@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "BuoyancyPontoonLayout.h"
+#include "OceanSamplerInterface.h"
+#include "UObject/WeakInterfacePtr.h"
+
+#include "BuoyantInstancedStaticMeshComponent.generated.h"
+
+/**
+ * Floats every instance on the ocean. The ocean is sampled for all instances in one batch
+ * and the instance transforms are written back in one bulk update,
+ * so a single component can carry thousands of pieces of debris.
+ * Instances keep the location and yaw they had when they were captured, see CaptureBuoyantInstances.
+ * Collision is off by default: with it every instance body is moved along each frame, which costs more
+ * than the buoyancy itself for large counts. Enable it only for small components that need to be hit.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class CATSPARADISE_API UBuoyantInstancedStaticMeshComponent : public UInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBuoyantInstancedStaticMeshComponent();
+
+	/** Pontoons shared by every instance, relative to the instance location, yaw and scale. Less than three pontoons disables tilting. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data")
+	TArray<FVector> PontoonsLocations = { FVector::ZeroVector };
+	/** Scales the tilt fitted through the pontoons, 1 follows the wave surface. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data")
+	float RotationStrength = 1;
+	/** If true, instances are only updated while the component was recently rendered. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data")
+	bool bOnlyUpdateWhenRendered = true;
+
+	/** Adds an instance that floats at the given world location and yaw. */
+	UFUNCTION(BlueprintCallable, Category = "Buoyancy")
+	int32 AddBuoyantInstance(const FTransform& WorldTransform);
+
+	/** Re-reads the anchor of every instance from its current transform. Call after adding or moving instances directly. */
+	UFUNCTION(BlueprintCallable, Category = "Buoyancy")
+	void CaptureBuoyantInstances();
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+public:
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	static constexpr int32 InstancesPerBatch = 256;
+
+	TWeakInterfacePtr<IOceanSamplerInterface> OceanSampler;
+	EOceanSamplingBackend OceanSamplerBackend = EOceanSamplingBackend::FFT;
+	bool bOceanSamplerSearched = false;
+	FBuoyancyPontoonLayout PontoonLayout;
+
+	// Per instance anchors, stored as separate arrays so the batches stream through them
+	TArray<float> AnchorX;
+	TArray<float> AnchorY;
+	TArray<float> AnchorYaw;
+	TArray<float> AnchorYawSin;
+	TArray<float> AnchorYawCos;
+	TArray<FVector> AnchorScale;
+
+	// Frame buffers, sized once per capture so ticking doesn't allocate
+	TArray<FVector> SamplePoints;
+	TArray<FVector> SampleDisplacements;
+	TArray<FTransform> InstanceTransforms;
+
+	IOceanSamplerInterface* UpdateOceanSampler();
+	void AddAnchor(const FTransform& WorldTransform);
+	void ResizeFrameBuffers();
+	void BuildSamplePoints(int32 StartInstance, int32 EndInstance);
+	void BuildInstanceTransforms(int32 StartInstance, int32 EndInstance);
+};
@@ -4,10 +4,30 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
-#include "OceanWaterZone.h"
+#include "OceanSamplerInterface.h"
+#include "UObject/WeakInterfacePtr.h"
+#include "BuoyancyPontoonLayout.h"
 
 #include "CatsParadiseBuoyancyComponent.generated.h"
 
+UENUM(BlueprintType)
+enum class EBuoyancySignificance : uint8
+{
+	Full UMETA(DisplayName = "Full Rate"),
+	Reduced UMETA(DisplayName = "Reduced Rate"),
+	Distant UMETA(DisplayName = "Distant"),
+	Paused UMETA(DisplayName = "Paused")
+};
+
+UENUM(BlueprintType)
+enum class EBuoyancyMode : uint8
+{
+	/** The mesh is placed directly onto the wave surface every update. */
+	Kinematic UMETA(DisplayName = "Kinematic"),
+	/** The mesh simulates physics and is pushed by per pontoon buoyancy and drag forces. */
+	Physics UMETA(DisplayName = "Physics")
+};
+
 /**
  * 
  */
@@ -21,37 +41,140 @@ public:
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data")
 	TArray<FVector> PontoonsLocations = { FVector::ZeroVector };
+	/** Scales the tilt fitted through the pontoons, 1 follows the wave surface. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data")
-	float RotationStrength = 5;
+	float RotationStrength = 1;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data")
 	bool DebugPoints = false;
+	/** The mesh isn't moved unless its location changes by more than this. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data", meta = (ClampMin = "0", Units = "Centimeters"))
+	float LocationUpdateThreshold = 0.1f;
+	/** The mesh isn't rotated unless its rotation changes by more than this. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data", meta = (ClampMin = "0", Units = "Degrees"))
+	float RotationUpdateThreshold = 0.05f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Data")
 	UStaticMeshComponent* MyStaticMeshComponent;
+	/** Physics mode requires MyStaticMeshComponent to simulate physics and Tick Async Physics in the physics settings. Can only be changed before BeginPlay. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Buoyancy Data")
+	EBuoyancyMode BuoyancyMode = EBuoyancyMode::Kinematic;
+
+	/** Buoyancy force relative to the weight of the mesh once every pontoon is fully submerged. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Physics", meta = (ClampMin = "0", EditCondition = "BuoyancyMode == EBuoyancyMode::Physics"))
+	float BuoyancyCoefficient = 2.f;
+	/** Depth at which a pontoon counts as fully submerged. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Physics", meta = (ClampMin = "1", EditCondition = "BuoyancyMode == EBuoyancyMode::Physics"))
+	float PontoonRadius = 50.f;
+	/** Horizontal water drag of a submerged pontoon, per unit of mass. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Physics", meta = (ClampMin = "0", EditCondition = "BuoyancyMode == EBuoyancyMode::Physics"))
+	float WaterDrag = 0.5f;
+	/** Vertical damping of a submerged pontoon, per unit of mass. Keeps the mesh from bobbing forever. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Physics", meta = (ClampMin = "0", EditCondition = "BuoyancyMode == EBuoyancyMode::Physics"))
+	float VerticalDamping = 2.f;
+
+	/**
+	 * If true, the ocean is sampled less often the further the nearest player is,
+	 * and the component pauses when it is neither rendered nor in range of any player.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Significance")
+	bool bUseSignificanceThrottling = true;
+	/** Players closer than this get buoyancy sampled every frame. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Significance", meta = (ClampMin = "0", EditCondition = "bUseSignificanceThrottling"))
+	float FullRateDistance = 5000.f;
+	/** Players closer than this get buoyancy sampled every ReducedSampleInterval. Further away the component is either distant or paused. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Significance", meta = (ClampMin = "0", EditCondition = "bUseSignificanceThrottling"))
+	float ReducedRateDistance = 20000.f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Significance", meta = (ClampMin = "0", EditCondition = "bUseSignificanceThrottling"))
+	float ReducedSampleInterval = 0.1f;
+	/** Sample interval used when out of range of every player but still rendered. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Significance", meta = (ClampMin = "0", EditCondition = "bUseSignificanceThrottling"))
+	float DistantSampleInterval = 0.5f;
+	/** How often a paused component wakes up to re-evaluate its significance. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Significance", meta = (ClampMin = "0", EditCondition = "bUseSignificanceThrottling"))
+	float PausedCheckInterval = 1.f;
+	/** How long ago the mesh may have been rendered to still count as visible. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Buoyancy Significance", meta = (ClampMin = "0", EditCondition = "bUseSignificanceThrottling"))
+	float RecentlyRenderedTolerance = 0.2f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Buoyancy Significance")
+	EBuoyancySignificance Significance = EBuoyancySignificance::Full;
 
 	UFUNCTION(BlueprintCallable, Category = "Buoyancy")
 	FVector GetBuoyancyLocation(FVector RelativeLocation);
 	UFUNCTION(BlueprintCallable, Category = "Buoyancy")
-	FVector GetMultiBuoyancyLocation(TArray<FVector> PontoonsArray);
+	FVector GetMultiBuoyancyLocation(const TArray<FVector>& PontoonsArray);
 	UFUNCTION(BlueprintCallable, Category = "Buoyancy")
-	TArray<FVector> GetBuoyancyArray(TArray<FVector> Points);
+	TArray<FVector> GetBuoyancyArray(const TArray<FVector>& Points);
+
+	/** Samples the buoyancy location of every relative point into OutLocations without allocating. */
+	void GetBuoyancyLocations(TConstArrayView<FVector> RelativeLocations, TArrayView<FVector> OutLocations);
 
 
 private:
 	AActor* ParentActor = nullptr;
-	AOceanWaterZone* OceanWaterZone;
 	FTransform ActorTransform;
 	FVector WorldActorLocation;
 	FRotator WorldActorRotation;
 	FVector RelativeStaticMeshLocation;
 	FRotator RelativeStaticMeshRotation;
-	FOceanFFTCalculator* FFTCalculator;
+	TWeakInterfacePtr<IOceanSamplerInterface> OceanSampler;
+	EOceanSamplingBackend OceanSamplerBackend = EOceanSamplingBackend::FFT;
 	bool bWaterZoneValid = true;
 
-	FOceanFFTCalculator* InitializeWaterZoneReference();
-	FVector FindAverageLocation(TArray<FVector> Locations);
-	FQuat CalculateBuoyancyRotation(const TArray<FVector> Points);
-	FQuat CalculateWaveRotation(const FVector& WavePoint);
-	void DrawBuoyancyArrayDebugPoints(const TArray<FVector>& BuoyancyArray);
+	struct FBuoyancySample
+	{
+		FVector Location = FVector::ZeroVector;
+		FQuat Rotation = FQuat::Identity;
+		float Time = -1.f;
+	};
+
+	// The two latest ocean samples, used to extrapolate between throttled updates
+	FBuoyancySample LastSample;
+	FBuoyancySample PreviousSample;
+
+	bool bHasAppliedTransform = false;
+	FVector LastAppliedLocation = FVector::ZeroVector;
+	FQuat LastAppliedRotation = FQuat::Identity;
+
+	// Per tick scratch storage, kept between ticks so sampling doesn't allocate
+	static constexpr int32 InlinePontoonCount = 8;
+	TArray<FVector, TInlineAllocator<InlinePontoonCount>> PontoonGridPoints;
+	TArray<FVector, TInlineAllocator<InlinePontoonCount>> PontoonDisplacements;
+	TArray<FVector, TInlineAllocator<InlinePontoonCount>> BuoyancyPoints;
+	TArray<float, TInlineAllocator<InlinePontoonCount>> PontoonHeights;
+
+	FBuoyancyPontoonLayout PontoonLayout;
+
+	// Everything the physics thread needs, written by the game thread under PhysicsInputLock
+	struct FBuoyancyPhysicsInput
+	{
+		TArray<FVector, TInlineAllocator<InlinePontoonCount>> PontoonOffsets;
+		TArray<float, TInlineAllocator<InlinePontoonCount>> SurfaceHeights;
+		float GravityZ = 0.f;
+		float BuoyancyCoefficient = 0.f;
+		float PontoonRadius = 1.f;
+		float WaterDrag = 0.f;
+		float VerticalDamping = 0.f;
+	};
+
+	FCriticalSection PhysicsInputLock;
+	FBuoyancyPhysicsInput PhysicsInput;
+	// Pontoons relative to the simulated mesh, as the mesh leaves the actor once it simulates
+	TArray<FVector, TInlineAllocator<InlinePontoonCount>> MeshPontoonOffsets;
+
+	void UpdateOceanSampler();
+	FVector FindAverageLocation(TConstArrayView<FVector> Locations);
+	FQuat CalculateBuoyancyRotation(TConstArrayView<FVector> Points);
+	void DrawBuoyancyArrayDebugPoints(TConstArrayView<FVector> BuoyancyArray);
+	template<typename TScratchArray>
+	void ResizeScratch(TScratchArray& Scratch, int32 Num);
+
+	EBuoyancySignificance CalculateSignificance() const;
+	void UpdateSignificance();
+	float GetSampleInterval() const;
+	void SampleBuoyancy(float WorldTime);
+	void ApplyBuoyancyTransform(float WorldTime);
+	void ResetBuoyancySamples();
+	void SamplePhysicsSurfaceHeights();
 
 protected:
 	// Called when the game starts
@@ -60,4 +183,6 @@ protected:
 public:	
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;	
+	// Called on the physics thread for every physics step while in physics mode
+	virtual void AsyncPhysicsTickComponent(float DeltaTime, float SimTime) override;
 };
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "EntityResourceSubsystem.h"
 #include "EntityResourceComponent.generated.h"
 
 USTRUCT(BlueprintType)
@@ -34,6 +35,12 @@ struct FResourceData
 		Category="EntityResourceComponent",
 		meta=(EditCondition="bCustomInitialValue", ClampMin="0"))
 	int32 InitialValue = 100;
+
+	/**
+	 * Value change per second, positive regenerates up to MaxValue and negative decays down to 0.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EntityResourceComponent")
+	float Rate = 0.f;
 	
 };
 
@@ -53,12 +60,11 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void InitializeComponent() override;
 
 public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
 	UPROPERTY(BlueprintAssignable, Category="EntityResourceComponent")
 	FOnResourceValueChange OnValueDecreased;
 
@@ -101,11 +107,63 @@ public:
 	UFUNCTION(BlueprintPure, Category="EntityResourceComponent")
 	int32 GetMaxValue() const;
 
+	/**
+	 * Sets the regeneration (positive) or decay (negative) per second.
+	 * The value is computed when read, OnValueZero and OnValueIncreased fire when it reaches 0 or MaxValue.
+	 * The rate is rounded to hundredths, the precision it is replicated with.
+	 */
+	UFUNCTION(BlueprintCallable, Category="EntityResourceComponent")
+	void SetRate(float Rate);
+
+	UFUNCTION(BlueprintPure, Category="EntityResourceComponent")
+	float GetRate() const;
+
 	void SetResourceData(const FResourceData& Data);
 
 	void GetResourceData(FResourceData& Data) const;
 
+	/** Broadcasts a change the UEntityResourceSubsystem applied in a bulk pass. */
+	void NotifyValueChanged(int32 AppliedAmount);
+
+	/** Broadcasts the net change of the batched notifications, called by the UEntityResourceSubsystem once per frame. */
+	void FlushNotifications();
+
+	/** Applies the state the server replicated and broadcasts the change, called by the AEntityResourceReplicator. */
+	void ApplyReplicatedState(int32 Value, int32 MaxValue, float Rate, double RateStartTime);
+
+	UFUNCTION(BlueprintPure, Category="EntityResourceComponent")
+	FEntityResourceHandle GetResourceHandle() const;
+
 private:
+	/**
+	 * The authored resource. While the component is in play Value and MaxValue live in the UEntityResourceSubsystem.
+	 */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="EntityResourceComponent", meta=(AllowPrivateAccess))
 	FResourceData ResourceData;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UEntityResourceSubsystem> ResourceSubsystem = nullptr;
+
+	FEntityResourceHandle ResourceHandle;
+
+	/**
+	 * If true the changes of a frame are broadcast once at the end of it, with the net amount of each kind of change,
+	 * instead of every change broadcasting on its own. Events with a zero net change are dropped.
+	 */
+	UPROPERTY(EditAnywhere, Category="EntityResourceComponent")
+	bool bBatchNotifications = false;
+
+	bool bNotificationPending = false;
+	int32 PendingOldValue = 0;
+	int32 PendingOldMaxValue = 0;
+
+	/** Starts batching the notifications of the current frame, returns true if they are batched. */
+	bool DeferNotification();
+
+	/** Broadcasts one event per kind of change from the given old values to the current ones. */
+	void BroadcastNetChange(int32 OldValue, int32 OldMaxValue);
+
+	void SetStoredValue(int32 Value);
+
+	void SetStoredMaxValue(int32 MaxValue);
 };
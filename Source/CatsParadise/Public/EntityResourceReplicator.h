@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "EntityResourceReplicator.generated.h"
+
+class AEntityResourceReplicator;
+class UEntityResourceComponent;
+
+/**
+ * The replicated state of one resource. Values are sent as packed integers and the rate in hundredths,
+ * so a typical change costs a few bytes. Clients predict regeneration and decay from the rate, the server keeps
+ * rates in hundredths as well and the start time is sent exactly, so both evaluate the same values.
+ */
+USTRUCT()
+struct FEntityResourceReplicatedItem : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UEntityResourceComponent> Component = nullptr;
+
+	UPROPERTY()
+	int32 Value = 0;
+
+	UPROPERTY()
+	int32 MaxValue = 0;
+
+	UPROPERTY()
+	float Rate = 0.f;
+
+	/** Server world time the rate applies from. */
+	UPROPERTY()
+	double RateStartTime = 0.0;
+
+	void PostReplicatedAdd(const struct FEntityResourceReplicatedArray& InArraySerializer);
+	void PostReplicatedChange(const struct FEntityResourceReplicatedArray& InArraySerializer);
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** Applies the state to the component on a client. */
+	void ApplyToComponent(const UWorld* World) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FEntityResourceReplicatedItem> : public TStructOpsTypeTraitsBase2<FEntityResourceReplicatedItem>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+USTRUCT()
+struct FEntityResourceReplicatedArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FEntityResourceReplicatedItem> Items;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<AEntityResourceReplicator> Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FEntityResourceReplicatedItem, FEntityResourceReplicatedArray>(Items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FEntityResourceReplicatedArray> : public TStructOpsTypeTraitsBase2<FEntityResourceReplicatedArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Replicates the resources of every replicated actor through one fast array, spawned by the UEntityResourceSubsystem
+ * on the server. Only changed items are sent, so hundreds of resources don't each need their own property replication.
+ */
+UCLASS(NotPlaceable, Transient)
+class CATSPARADISE_API AEntityResourceReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AEntityResourceReplicator();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void BeginPlay() override;
+
+	void AddResource(UEntityResourceComponent* Component, int32 Value, int32 MaxValue, float Rate, double RateStartTime);
+	void UpdateResource(UEntityResourceComponent* Component, int32 Value, int32 MaxValue, float Rate, double RateStartTime);
+	void RemoveResource(const UEntityResourceComponent* Component);
+
+	/** Applies the state received for the component, for components that begin play after their state arrived. */
+	void ApplyReceivedState(const UEntityResourceComponent* Component) const;
+
+private:
+	UPROPERTY(Replicated)
+	FEntityResourceReplicatedArray ReplicatedResources;
+
+	/** Item index of every replicated component, server only. */
+	TMap<TObjectKey<UEntityResourceComponent>, int32> ItemIndices;
+
+	static void SetItemState(FEntityResourceReplicatedItem& Item, int32 Value, int32 MaxValue, float Rate, double RateStartTime);
+};
@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PackedEntityResources.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EntityResourceSubsystem.generated.h"
+
+class AEntityResourceReplicator;
+class UEntityResourceComponent;
+
+DECLARE_STATS_GROUP(TEXT("EntityResource"), STATGROUP_EntityResource, STATCAT_Advanced);
+
+/** Refers to a resource stored in the UEntityResourceSubsystem, stale once the resource is removed. */
+USTRUCT(BlueprintType)
+struct FEntityResourceHandle
+{
+	GENERATED_BODY()
+
+	int32 Slot = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsSet() const { return Slot != INDEX_NONE; }
+
+	bool operator==(const FEntityResourceHandle& Other) const { return Slot == Other.Slot && Generation == Other.Generation; }
+};
+
+/**
+ * Hashed timing wheel of resource timers. Timers are put in the slot of their due time modulo the wheel size,
+ * advancing only visits the slots of the elapsed time, timers more than a turn away wait for later turns.
+ */
+struct FEntityResourceTimingWheel
+{
+	struct FTimer
+	{
+		FEntityResourceHandle Handle;
+		uint32 Serial = 0;
+		int64 Tick = 0;
+	};
+
+	void Add(FEntityResourceHandle Handle, uint32 Serial, double Time);
+
+	/** Moves every timer due at Time or before into OutExpired. */
+	void Advance(double Time, TArray<FTimer>& OutExpired);
+
+	void Reset();
+
+private:
+	static constexpr double SlotDuration = 0.1;
+	static constexpr int32 NumSlots = 512;
+
+	TArray<TArray<FTimer>> Slots;
+	/** The last tick that was advanced over. */
+	int64 CurrentTick = -1;
+};
+
+/**
+ * Stores the values of every UEntityResourceComponent of the world in contiguous arrays.
+ * Components only keep a handle, so bulk changes like area damage or regeneration run as one vectorized pass
+ * over all resources, and the components are only notified about the resources that changed afterwards.
+ * Regeneration and decay are stored as a rate from the time the value was last set and evaluated when read,
+ * the only per resource work over time is a timer in the timing wheel at the time the value reaches 0 or the max.
+ * On a server the resources of replicated actors are sent through an AEntityResourceReplicator, changed resources
+ * near players are sent more often than the ones far from every player.
+ * Entities without a component, like ambient creatures, keep their resources in the packed resources instead.
+ */
+UCLASS()
+class CATSPARADISE_API UEntityResourceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Rates are kept in steps of 1 / RateScale, the precision they are replicated with. */
+	static constexpr float RateScale = 100.f;
+
+	static float QuantizeRate(float Rate);
+
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	FEntityResourceHandle AddResource(UEntityResourceComponent* Component, int32 Value, int32 MaxValue);
+	void RemoveResource(FEntityResourceHandle Handle);
+	bool IsValidHandle(FEntityResourceHandle Handle) const;
+
+	int32 GetValue(FEntityResourceHandle Handle) const;
+	int32 GetMaxValue(FEntityResourceHandle Handle) const;
+	void SetValue(FEntityResourceHandle Handle, int32 Value);
+	void SetMaxValue(FEntityResourceHandle Handle, int32 MaxValue);
+
+	/** Value change per second, positive regenerates up to the max and negative decays down to 0. */
+	float GetRate(FEntityResourceHandle Handle) const;
+	void SetRate(FEntityResourceHandle Handle, float Rate);
+
+	/**
+	 * Changes the value of every resource whose owner is within Radius of Center by Delta,
+	 * clamped to 0 and MaxValue. Returns the number of changed resources.
+	 */
+	UFUNCTION(BlueprintCallable, Category="EntityResource")
+	int32 ApplyRadialDelta(const FVector& Center, float Radius, int32 Delta);
+
+	/** Changes the value of every resource by Delta, clamped to 0 and MaxValue. Returns the number of changed resources. */
+	UFUNCTION(BlueprintCallable, Category="EntityResource")
+	int32 ApplyDeltaToAll(int32 Delta);
+
+	UFUNCTION(BlueprintPure, Category="EntityResource")
+	int32 GetNumResources() const;
+
+	/** Flushes the batched notifications of the component on the next tick. */
+	void QueueNotification(UEntityResourceComponent* Component);
+
+	/** Sets the replicator resources are sent through, on a server every resource already stored is added to it. */
+	void SetReplicator(AEntityResourceReplicator* InReplicator);
+
+	/** Overwrites the resource with the state received from the server, RateStartTime is in local world time. */
+	void SetReplicatedState(FEntityResourceHandle Handle, int32 Value, int32 MaxValue, float Rate, double RateStartTime);
+
+	/** Applies the state the client already received for the component, if any. */
+	void ApplyReceivedState(const UEntityResourceComponent* Component) const;
+
+	FPackedEntityResources& GetPackedResources();
+
+private:
+	struct FResourceSlot
+	{
+		int32 DenseIndex = INDEX_NONE;
+		uint32 Generation = 0;
+	};
+
+	TArray<FResourceSlot> Slots;
+	TArray<int32> FreeSlots;
+
+	// dense arrays, removing a resource moves the last one into its place
+	TArray<int32> Values;
+	TArray<int32> MaxValues;
+	TArray<float> Rates;
+	/** World time Values were last set at, the rate applies from there. */
+	TArray<double> RateStartTimes;
+	/** Bumped whenever the timer of a resource is replaced, so the old one is ignored. */
+	TArray<uint32> TimerSerials;
+	TArray<TWeakObjectPtr<UEntityResourceComponent>> Components;
+	TArray<int32> DenseToSlot;
+
+	// scratch buffers of the bulk passes
+	TArray<int32> AppliedDeltas;
+	TArray<float> RelativeX;
+	TArray<float> RelativeY;
+	TArray<float> RelativeZ;
+
+	TArray<TWeakObjectPtr<UEntityResourceComponent>> PendingNotifications;
+
+	TWeakObjectPtr<AEntityResourceReplicator> Replicator;
+	/** Set for resources changed since they were last sent, server only. */
+	TArray<bool> ReplicationDirty;
+	TArray<double> LastReplicationTimes;
+	int32 NumReplicationDirty = 0;
+
+	FPackedEntityResources PackedResources;
+
+	FEntityResourceTimingWheel TimingWheel;
+	TArray<FEntityResourceTimingWheel::FTimer> ExpiredTimers;
+
+	int32 FindDenseIndex(FEntityResourceHandle Handle) const;
+	FEntityResourceHandle MakeHandle(int32 DenseIndex) const;
+	double GetTime() const;
+
+	/** The value with the rate applied up to Time. */
+	int32 EvaluateValue(int32 DenseIndex, double Time) const;
+
+	/** Applies the rate to the stored value and restarts the rate from Time, returns the applied amount. */
+	int32 RebaseValue(int32 DenseIndex, double Time);
+
+	/** Rebases every resource with a rate, called before bulk passes read the stored values. */
+	void RebaseAllValues(double Time);
+
+	bool ShouldReplicate(int32 DenseIndex) const;
+	void MarkReplicationDirty(int32 DenseIndex);
+
+	/** Sends the changed resources whose update interval passed. */
+	void ReplicateDirtyResources(double Time);
+
+	/** Replaces the timer of the resource with one at the time its value reaches 0 or the max. */
+	void ScheduleBoundary(int32 DenseIndex);
+
+	/** Notifies the components of every resource with a non zero applied delta. */
+	int32 NotifyAppliedDeltas();
+
+	void NotifyChanges(const TArray<TPair<TWeakObjectPtr<UEntityResourceComponent>, int32>>& Changes);
+};
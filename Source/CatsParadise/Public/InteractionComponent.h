@@ -7,6 +7,16 @@
 #include "Components/SphereComponent.h"
 #include "InteractionComponent.generated.h"
 
+UENUM(BlueprintType)
+enum class EInteractionDiscovery : uint8
+{
+	/** Pawns are found by the overlap events of the sphere. */
+	Overlap,
+	/** Pawns are found through UInteractionGridSubsystem, the sphere doesn't overlap pawns. */
+	SpatialHash
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInteractionDormancyChanged, bool, bIsDormant);
 
 UCLASS( Blueprintable, BlueprintType, ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class CATSPARADISE_API UInteractionComponent : public USphereComponent
@@ -20,20 +30,27 @@ public:
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport) override;
 
 public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-	
 	UPROPERTY(EditAnywhere, Category="InteractionSystem")
 	bool bInteractOnOverlap;
 
+	/** How pawns entering the sphere are found. Only read on BeginPlay. */
+	UPROPERTY(EditAnywhere, Category="InteractionSystem")
+	EInteractionDiscovery Discovery = EInteractionDiscovery::Overlap;
+
 	UPROPERTY(BlueprintAssignable, Category="InteractionSystem")
 	FOnQueueChanged OnActorAdded;
 
 	UPROPERTY(BlueprintAssignable, Category="InteractionSystem")
 	FOnQueueChanged OnActorRemoved;
 
+	/** Called when the component falls asleep or wakes up, only spatial hash discovery makes it dormant. */
+	UPROPERTY(BlueprintAssignable, Category="InteractionSystem")
+	FOnInteractionDormancyChanged OnDormancyChanged;
+
 	UFUNCTION(BlueprintCallable, Category="InteractionSystem")
 	void SetInteractionMessage(AActor* Actor, const FString& Message);
 
@@ -63,6 +80,12 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category="InteractionSystem")
 	static void SetTriggerDefaultCollision(UShapeComponent* ShapeComponent);
+
+	/** A dormant component has no collision, so it costs nothing to the physics scene queries. */
+	void SetDormant(bool bNewDormant);
+
+	UFUNCTION(BlueprintPure, Category="InteractionSystem")
+	bool IsDormant() const;
 	
 private:
 	UPROPERTY(EditDefaultsOnly,
@@ -72,6 +95,11 @@ private:
 		meta=(AllowPrivateAccess))
 	FInteractionData InteractionData;
 
+	bool bDormant = false;
+
+	/** The collision to restore when waking up. */
+	TEnumAsByte<ECollisionEnabled::Type> AwakeCollisionEnabled = ECollisionEnabled::QueryOnly;
+
 	UFUNCTION()
 	virtual void HandleBeginOverlap(UPrimitiveComponent* OverlappedComponent,
 									AActor* OtherActor,
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "InteractionGridSubsystem.generated.h"
+
+class UInteractionComponent;
+
+/**
+ * Finds interactables around players without physics overlaps.
+ * Interaction components using spatial hash discovery are kept in a uniform grid of interaction.GridCellSize cells,
+ * every actor with an interaction queue checks the cells around it when it moved or an interactable in one of
+ * those cells changed, and gets BeginOverlap/EndOverlap called on the interaction components its capsule enters and leaves.
+ * Interactables farther than interaction.GridWakeDistance from every seeker are dormant.
+ */
+UCLASS()
+class CATSPARADISE_API UInteractionGridSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterInteractable(UInteractionComponent* Interactable);
+	void UnregisterInteractable(UInteractionComponent* Interactable);
+	void UpdateInteractable(UInteractionComponent* Interactable);
+
+	/** Makes every seeker query again without the interactable moving, e.g. when its owner's collision was toggled. */
+	void RefreshInteractable(UInteractionComponent* Interactable);
+
+	/** Seekers are the actors that discover interactables, i.e. the owners of interaction queues. */
+	void RegisterSeeker(AActor* Seeker);
+	void UnregisterSeeker(AActor* Seeker);
+
+private:
+	struct FInteractableEntry
+	{
+		TWeakObjectPtr<UInteractionComponent> Component;
+		FVector Location = FVector::ZeroVector;
+		float Radius = 0.f;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		/** Seekers within the wake distance, the interactable is dormant while there are none. */
+		int32 NumNearbySeekers = 0;
+	};
+
+	struct FSeekerEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FVector QueryLocation = FVector::ZeroVector;
+		/** The cells covered by the last query, changes in other cells don't concern the seeker. */
+		FIntPoint QueryMinCell = FIntPoint::ZeroValue;
+		FIntPoint QueryMaxCell = FIntPoint::ZeroValue;
+		float QueryRange = 0.f;
+		bool bQueried = false;
+		/** Sorted ids of the interactables the seeker is inside of. */
+		TArray<int32> Inside;
+		/** Sorted ids of the interactables within the wake distance, always contains Inside. */
+		TArray<int32> Nearby;
+	};
+
+	TSparseArray<FInteractableEntry> Interactables;
+	TMap<TObjectKey<UInteractionComponent>, int32> InteractableIds;
+	TMap<FIntPoint, TArray<int32>> Cells;
+	TArray<FSeekerEntry> Seekers;
+
+	/** Cells interactables were added to, removed from, moved in or refreshed in since the last tick. */
+	TArray<FIntPoint> DirtyCells;
+	/** The query range around a seeker has to cover the largest interactable. */
+	float MaxInteractableRadius = 0.f;
+
+	FIntPoint GetCell(const FVector& Location) const;
+	void MarkCellDirty(const FIntPoint& Cell);
+	bool NeedsQuery(const FSeekerEntry& Seeker, float QueryDistanceSquared) const;
+	float GetQueryRange(float SeekerRadius) const;
+	void AddToCell(int32 Id, const FIntPoint& Cell);
+	void RemoveFromCell(int32 Id, const FIntPoint& Cell);
+	void QuerySeeker(FSeekerEntry& Seeker, TArray<int32>& OutInside, TArray<int32>& OutNearby) const;
+	void UpdateSeeker(FSeekerEntry& Seeker, const TArray<int32>& NewInside, const TArray<int32>& NewNearby);
+};
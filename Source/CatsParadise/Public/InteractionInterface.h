@@ -41,3 +41,25 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category="Interaction")
 	void StopInteraction(AActor* OtherActor);
 };
+
+/**
+ * How an object implements IInteractionInterface, resolved once when it enters an interaction queue.
+ * Objects that implement the interface natively without Blueprint overrides are called directly,
+ * everything else goes through the reflected Execute_ functions.
+ */
+struct CATSPARADISE_API FInteractionDispatch
+{
+	/** Set when every interaction event can be called natively. */
+	IInteractionInterface* NativeInterface = nullptr;
+
+	bool bImplementsInterface = false;
+
+	static FInteractionDispatch Resolve(UObject* Object);
+
+	/** True if Class overrides the native event FunctionName in Blueprint. */
+	static bool HasBlueprintOverride(const UClass* Class, FName FunctionName);
+
+	void StartInteraction(UObject* Object, AActor* OtherActor) const;
+	bool FinishInteraction(UObject* Object, AActor* OtherActor) const;
+	void StopInteraction(UObject* Object, AActor* OtherActor) const;
+};
@@ -3,8 +3,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "InteractionInterface.h"
 #include "Components/ActorComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "PlayerFocusSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "InteractionQueueComponent.generated.h"
 
 USTRUCT(BlueprintType)
@@ -24,6 +27,12 @@ struct FInteractionData
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="InteractionData")
 	FString InteractionMessage = "Interact";
 
+	/**
+	 * Added to the target score, higher priority targets are picked over closer ones.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="InteractionData")
+	float Priority = 0.f;
+
 	/**
 	 * How much time required to activate interaction effect.
 	 */
@@ -41,6 +50,16 @@ struct FQueueData
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="QueueData")
 	FInteractionData InteractionData;
+
+	/** Position in the queue order, the rank and the score in the high bits and the insertion order in the low bits. */
+	uint64 SortKey = 0;
+
+	/** Target score and the actor location it was computed at. */
+	float Score = 0.f;
+	FVector ScoredLocation = FVector::ZeroVector;
+
+	/** How the actor's interaction events are called, resolved when it entered the queue. */
+	FInteractionDispatch Dispatch;
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnInteraction, AActor*, TargetActor);
@@ -59,6 +78,8 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:	
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -154,6 +175,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category="InteractionSystem")
 	bool GetPlayerViewport(const AActor* Actor, FVector& ViewLocation, FRotator& ViewRotation);
 
+	/** The focus trace of the line of sight, other systems of the owner use it to share the trace. */
+	FPlayerFocusTraceSettings GetSightTraceSettings() const;
+
+protected:
+	/** Scores a queued target, higher is better. */
+	virtual float ScoreQueueData(const FQueueData& Data, const FVector& OwnerLocation, const FVector& ViewLocation, const FVector& ViewDirection) const;
+
 private:
 	/** If true, the FinishInteraction() must be called manually.*/
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Interaction", meta=(AllowPrivateAccess))
@@ -193,12 +221,65 @@ private:
 		meta=(AllowPrivateAccess, EditCondition="bUseLineOfSight"))
 	float DebugDrawTime = 0.05f;
 
+	/**
+	 * Orders the targets inside the same line of sight rank by score,
+	 * the score is the priority minus the distance plus the facing towards the target.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Interaction|Scoring", meta=(AllowPrivateAccess))
+	bool bScoreTargets = true;
+
+	/** Score of one priority point. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="Interaction|Scoring",
+		meta=(AllowPrivateAccess, EditCondition="bScoreTargets"))
+	float PriorityWeight = 1.f;
+
+	/** Score lost per meter between the owner and the target. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="Interaction|Scoring",
+		meta=(AllowPrivateAccess, EditCondition="bScoreTargets"))
+	float DistanceWeight = 1.f;
+
+	/** Score of looking straight at the target, scaled by the cosine of the view angle. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="Interaction|Scoring",
+		meta=(AllowPrivateAccess, EditCondition="bScoreTargets"))
+	float ViewAngleWeight = 1.f;
+
 	/** The actor caught by line of sight. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Interaction", meta=(AllowPrivateAccess))
 	AActor* ActorInSight = nullptr;
 
+	/**
+	 * Sort key of every queued actor. The queue itself is kept ordered by the key,
+	 * so an actor is found with one map lookup and a binary search.
+	 */
+	TMap<TObjectKey<AActor>, uint64> QueueSortKeys;
+
+	/** Insertion counter, keeps the order of actors with the same rank stable. */
+	uint32 NextQueueSequence = 0;
+
+	/** Bumped whenever actors enter or leave the queue, the sight is traced again when it changes. */
+	uint32 QueueRevision = 0;
+
+	/** The view the scores were computed from, targets are only rescored when it or their location changes. */
+	FVector ScoredViewLocation = FVector::ZeroVector;
+	FVector ScoredViewDirection = FVector::ZeroVector;
+	FVector ScoredOwnerLocation = FVector::ZeroVector;
+
 	AActor* GetActorInSight();
 
-	void SortByLineOfSight(const AActor* Actor);
+	void SetActorInSight(AActor* Actor);
+
+	uint64 MakeSortKey(const FQueueData& Data, uint32 Sequence) const;
+
+	int32 FindQueueIndex(const AActor* Actor) const;
+
+	void InsertQueueData(FQueueData&& Data);
+
+	void RefreshSortKey(const AActor* Actor);
+
+	FInteractionDispatch GetInteractionDispatch(AActor* Actor) const;
+
+	void GetScoringView(FVector& ViewLocation, FVector& ViewDirection);
+
+	void UpdateTargetScores();
 		
 };
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NiagaraDataInterface.h"
+
+#include "NiagaraDataInterfaceOceanSampler.generated.h"
+
+/**
+ * Lets CPU emitters sample the ocean displacement calculated by the AOceanWaterZone.
+ * Each system instance takes a read-only snapshot of the displacement grids once per frame
+ * and every particle of an emitter is then sampled from it in batches, so foam, spray and floating
+ * particles can ride the waves without per-particle queries on the game thread.
+ */
+UCLASS(EditInlineNew, Category = "Ocean", meta = (DisplayName = "Ocean Sampler"))
+class CATSPARADISE_API UNiagaraDataInterfaceOceanSampler : public UNiagaraDataInterface
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostInitProperties() override;
+
+	virtual void GetFunctions(TArray<FNiagaraFunctionSignature>& OutFunctions) override;
+	virtual void GetVMExternalFunction(const FVMExternalFunctionBindingInfo& BindingInfo, void* InstanceData, FVMExternalFunction& OutFunc) override;
+	virtual bool CanExecuteOnTarget(ENiagaraSimTarget Target) const override { return Target == ENiagaraSimTarget::CPUSim; }
+
+	virtual int32 PerInstanceDataSize() const override;
+	virtual bool InitPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance) override;
+	virtual void DestroyPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance) override;
+	virtual bool PerInstanceTick(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance, float DeltaSeconds) override;
+
+private:
+	void SampleOcean(FVectorVMExternalFunctionContext& Context);
+};
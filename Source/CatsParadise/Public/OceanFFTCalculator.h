@@ -8,6 +8,29 @@ class UNiagaraSystem;
 DECLARE_STATS_GROUP(TEXT("Ocean"), STATGROUP_Ocean, STATCAT_Advanced);
 #define OCEAN_SCOPE_CYCLE_COUNTER(Name) DECLARE_SCOPE_CYCLE_COUNTER(TEXT(#Name), STAT_##Name, STATGROUP_Ocean)
 
+// Read-only copy of the displacement grids for a single frame, safe to sample from worker threads
+// while the calculator keeps stepping the simulation on the game thread
+struct FOceanDisplacementSnapshot {
+
+public:
+
+    float EngineTime = -1.f;
+
+    void SampleDisplacements(const float* PositionX, const float* PositionY, float* OutDisplacementX, float* OutDisplacementY, float* OutDisplacementZ, int32 NumPoints) const;
+
+private:
+
+    friend struct FOceanFFTCalculator;
+
+    double PatchLength[NUM_CASCADES];
+
+    float DisplacementGridX[GRID_SIZE * GRID_SIZE * NUM_CASCADES];
+    float DisplacementGridY[GRID_SIZE * GRID_SIZE * NUM_CASCADES];
+    float DisplacementGridZ[GRID_SIZE * GRID_SIZE * NUM_CASCADES];
+};
+
+typedef TSharedPtr<const FOceanDisplacementSnapshot, ESPMode::ThreadSafe> FOceanDisplacementSnapshotPtr;
+
 struct FOceanFFTCalculator {
 
 public:
@@ -18,18 +41,30 @@ public:
     void ShowDebugDisplacementPoints(UWorld* World, const FVector& CharacterLocation);
 
     FVector GetDisplacementAtPoint(FVector PointLocation);
+    void GetDisplacementAtPoints(TConstArrayView<FVector> PointLocations, TArrayView<FVector> OutDisplacements);
+
+    // Copies the current displacement grids at most once per calculated frame, game thread only
+    FOceanDisplacementSnapshotPtr GetDisplacementSnapshot();
 
 // Calculation data
 private:
 
     float CalculatedEngineTime = -1.f;
 
+    // double buffered so last frame's snapshot can still be read while the next one is filled,
+    // a slot is only reused once nobody else holds a reference to it
+    TSharedPtr<FOceanDisplacementSnapshot, ESPMode::ThreadSafe> DisplacementSnapshots[2];
+    int32 CurrentSnapshotIndex = INDEX_NONE;
+
 // Value sampling and debugging
 private:
 
     const int32 DebugGridSize = 10;
     const float DebugGridCellSize = 200.f;
 
+    // points are converted to SoA on the stack in chunks of this size before the ISPC lookup
+    static constexpr int32 SampleChunkSize = 256;
+
     FVector GetCascadeValue(FVector PointLocation, int32 CascadeIndex);
 
 // Shader emulation logic
@@ -2,13 +2,29 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "OceanSamplerInterface.h"
 #include "OceanManager.generated.h"
 
+// Per wave constants in the layout the ISPC kernels stream through
+struct FOceanGerstnerWaves
+{
+ // 2 clusters of 8 waves
+ static constexpr int32 NumWaves = 16;
+
+ float DirectionX[NumWaves];
+ float DirectionY[NumWaves];
+ float WaveNumber[NumWaves];
+ float Phase[NumWaves];
+ float HorizontalAmplitudeX[NumWaves];
+ float HorizontalAmplitudeY[NumWaves];
+ float VerticalAmplitude[NumWaves];
+};
+
 /**
  *
  */
 UCLASS()
-class CATSPARADISE_API AOceanManager : public AActor
+class CATSPARADISE_API AOceanManager : public AActor, public IOceanSamplerInterface
 {
  GENERATED_BODY()
 
@@ -38,15 +54,72 @@ public:
  UPROPERTY(BlueprintReadWrite, Category = "Ocean", EditAnywhere)
   FVector2D Direction;
 
+ // Bakes the waves into a periodic table so lookups become bilinear fetches instead of evaluating every wave.
+ // Wave vectors are snapped so the waves tile over BakedTileSize, see GetAnalyticWaveHeightValue for the exact waves.
+ UPROPERTY(BlueprintReadWrite, Category = "Ocean|Baking", EditAnywhere)
+  bool bBakeWaves = false;
+
+ UPROPERTY(BlueprintReadWrite, Category = "Ocean|Baking", EditAnywhere, meta = (EditCondition = "bBakeWaves", ClampMin = "1000", Units = "Centimeters"))
+  float BakedTileSize = 10000;
+
+ UPROPERTY(BlueprintReadWrite, Category = "Ocean|Baking", EditAnywhere, meta = (EditCondition = "bBakeWaves", ClampMin = "8", ClampMax = "256"))
+  int32 BakedGridSize = 64;
+
+ // Frames baked over one animation period, the waves repeat every 2 PI seconds
+ UPROPERTY(BlueprintReadWrite, Category = "Ocean|Baking", EditAnywhere, meta = (EditCondition = "bBakeWaves", ClampMin = "4", ClampMax = "128"))
+  int32 BakedFrameCount = 32;
+
  UFUNCTION(BlueprintCallable, Category = "Ocean")
   void Initialize();
 
  UFUNCTION(BlueprintCallable, Category = "Ocean")
   FVector GetWaveHeightValue(FVector location, float time);
 
+ // Always evaluates the unsnapped waves, even when they are baked
+ UFUNCTION(BlueprintCallable, Category = "Ocean")
+  FVector GetAnalyticWaveHeightValue(FVector location, float time);
+
+ // Evaluates all waves, or looks them up in the baked table, for every location in one vectorized pass
+ void GetWaveHeightValues(TConstArrayView<FVector> Locations, float Time, TArrayView<FVector> OutValues);
+
+ // Samples the waves at the current world time
+ virtual void GetOceanDisplacements(TConstArrayView<FVector> Locations, TArrayView<FVector> OutDisplacements) override;
+
+#if WITH_EDITOR
+ virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 private:
- 
- FVector CalculateGerstnerWave(float wavelength, float amplitude, FVector2D position, FVector2D direction, float angle, float steepness, float time, float phase);
- FVector CalculateGerstnerWaveCluster(float medianWavelength, float medianAmplitude, FVector2D position, FVector2D medianDirection, float medianAngle, float steepness, float time, float medianPhase);
+
+ static constexpr int32 SampleChunkSize = 256;
+
+ // the cluster and total averages are folded into the amplitudes
+ FOceanGerstnerWaves Waves;
+
+ // the wave properties are BlueprintReadWrite, so the table remembers what it was built from
+ bool bWavesBuilt = false;
+ float BuiltWavelength = 0;
+ float BuiltAmplitude = 0;
+ FVector2D BuiltDirection = FVector2D::ZeroVector;
+
+ // snapped waves and the Frames x Grid x Grid displacement table baked from them
+ bool bWavesBaked = false;
+ float BakedTileSizeUsed = 0;
+ float BakedInvTileSize = 0;
+ int32 BakedGridSizeUsed = 0;
+ int32 BakedFrameCountUsed = 0;
+ FOceanGerstnerWaves BakedWaves;
+ TArray<float> BakedX;
+ TArray<float> BakedY;
+ TArray<float> BakedZ;
+
+ void UpdateWaves();
+ void BuildWaves();
+ void BakeWaves();
+ bool IsBakeOutOfDate() const;
+ void SnapWavesToTile();
+ void EvaluateWaves(const FOceanGerstnerWaves& WaveSet, TConstArrayView<FVector> Locations, float Time, TArrayView<FVector> OutValues) const;
+ void SampleBakedWaves(TConstArrayView<FVector> Locations, float Time, TArrayView<FVector> OutValues) const;
+ void AddWaveCluster(int32 FirstWaveIndex, float medianWavelength, float medianAmplitude, float medianAngle, float steepness, float medianPhase);
 
 };
\ No newline at end of file
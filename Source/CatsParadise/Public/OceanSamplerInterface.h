@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "OceanSamplerInterface.generated.h"
+
+UENUM(BlueprintType)
+enum class EOceanSamplingBackend : uint8
+{
+	/** The FFT simulation of the AOceanWaterZone. */
+	FFT UMETA(DisplayName = "FFT"),
+	/** The analytic Gerstner waves of the AOceanManager, cheaper for low end hardware and servers. */
+	Gerstner UMETA(DisplayName = "Gerstner")
+};
+
+// This class does not need to be modified.
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class UOceanSamplerInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * An interface implemented by every ocean model that buoyancy can be sampled from.
+ * Displacements are relative to the point on the undisplaced ocean surface at world Z 0.
+ */
+class CATSPARADISE_API IOceanSamplerInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 * Samples the current ocean displacement at every location in one batch. Game thread only.
+	 */
+	virtual void GetOceanDisplacements(TConstArrayView<FVector> Locations, TArrayView<FVector> OutDisplacements) = 0;
+
+	FVector GetOceanDisplacement(const FVector& Location);
+
+	/**
+	 * The backend selected with ocean.SamplingBackend.
+	 */
+	static EOceanSamplingBackend GetSamplingBackend();
+
+	/**
+	 * Finds the ocean of the selected backend in the world, or the other one if the world doesn't have it.
+	 */
+	static IOceanSamplerInterface* FindOceanSampler(UWorld* World);
+};
@@ -2,11 +2,12 @@
 
 #include "WaterZoneActor.h"
 #include "OceanFFTCalculator.h"
+#include "OceanSamplerInterface.h"
 
 #include "OceanWaterZone.generated.h"
 
 UCLASS(BlueprintType)
-class AOceanWaterZone : public AWaterZone
+class AOceanWaterZone : public AWaterZone, public IOceanSamplerInterface
 {
     GENERATED_BODY()
 
@@ -18,6 +19,8 @@ public:
     bool ShouldTickIfViewportsOnly() const;
 
     void UpdatePosition(FVector NewLocation);
+
+    virtual void GetOceanDisplacements(TConstArrayView<FVector> Locations, TArrayView<FVector> OutDisplacements) override;
 	
     FOceanFFTCalculator FFTCalculator;
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PackedEntityResources.generated.h"
+
+/**
+ * Resource template shared by every packed resource of a kind of entity, e.g. one per species of fish.
+ */
+USTRUCT(BlueprintType)
+struct FPackedResourceArchetype
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EntityResource", meta=(ClampMin="0", ClampMax="65535"))
+	int32 MaxValue = 100;
+
+	/**
+	 * If true Value = InitialValue, else Value = MaxValue on resource creation.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="EntityResource")
+	bool bUseCustomInitialValue = false;
+
+	UPROPERTY(EditAnywhere,
+		BlueprintReadWrite,
+		Category="EntityResource",
+		meta=(EditCondition="bUseCustomInitialValue", ClampMin="0", ClampMax="65535"))
+	int32 InitialValue = 100;
+};
+
+/** Refers to a packed resource, stale once the resource is removed. */
+USTRUCT(BlueprintType)
+struct FPackedResourceHandle
+{
+	GENERATED_BODY()
+
+	int32 Index = INDEX_NONE;
+	uint16 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+
+	bool operator==(const FPackedResourceHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+};
+
+/**
+ * Resources of entities too numerous for a UEntityResourceComponent each, like ambient fish and birds.
+ * A resource is a 16 bit value and max value in flat arrays, the initial value lives in its archetype.
+ * Indices are stable, removed resources are zeroed and reused, so bulk passes run over the arrays without indirection.
+ * There are no rates and no events, the bulk passes report the resources they depleted instead.
+ */
+struct CATSPARADISE_API FPackedEntityResources
+{
+	/** Registers a template, returns the index resources are added with. */
+	int32 AddArchetype(const FPackedResourceArchetype& Archetype);
+
+	FPackedResourceHandle Add(int32 ArchetypeIndex);
+	void Remove(FPackedResourceHandle Handle);
+	bool IsValidHandle(FPackedResourceHandle Handle) const;
+
+	int32 GetValue(FPackedResourceHandle Handle) const;
+	int32 GetMaxValue(FPackedResourceHandle Handle) const;
+
+	/** Values are clamped to the 16 bit range. */
+	void SetValue(FPackedResourceHandle Handle, int32 Value);
+	void SetMaxValue(FPackedResourceHandle Handle, int32 MaxValue);
+
+	/** Restores the max and initial value of the resource's archetype. */
+	void ResetToArchetype(FPackedResourceHandle Handle);
+
+	/**
+	 * Changes the value of every resource by Delta, clamped to 0 and MaxValue.
+	 * Returns the number of changed resources, the ones that reached 0 are added to OutDepleted.
+	 */
+	int32 ApplyDeltaToAll(int32 Delta, TArray<FPackedResourceHandle>* OutDepleted = nullptr);
+
+	/** Changes the value of the given resources by Delta, for subsets like the entities in an area. */
+	int32 ApplyDelta(TConstArrayView<FPackedResourceHandle> Handles, int32 Delta, TArray<FPackedResourceHandle>* OutDepleted = nullptr);
+
+	int32 Num() const;
+
+	/** Bytes used by the resources, for memory reports. */
+	SIZE_T GetAllocatedSize() const;
+
+	void Reset();
+
+private:
+	TArray<FPackedResourceArchetype> Archetypes;
+
+	// hot arrays read by the bulk passes, free indices have a value and max value of 0
+	TArray<uint16> Values;
+	TArray<uint16> MaxValues;
+
+	TArray<uint16> ArchetypeIndices;
+	TArray<uint16> Generations;
+	TArray<int32> FreeIndices;
+
+	// scratch buffer of the bulk passes
+	TArray<int32> DepletedIndices;
+
+	bool IsValidIndex(FPackedResourceHandle Handle) const;
+	FPackedResourceHandle MakeHandle(int32 Index) const;
+};
@@ -37,9 +37,6 @@ protected:
 	virtual void BeginPlay() override;
 
 public:
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	UPROPERTY(BlueprintAssignable, Category="Item")
 	FOnUseItem OnUseItem;
 	
@@ -104,6 +101,18 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category="Pickup")
 	FHitResult GetFloor();
+
+	UFUNCTION(BlueprintCallable, Category="Pickup")
+	bool IsPooled() const;
+
+	/** True while no player is near, see UInteractionComponent::SetDormant. */
+	bool IsDormant() const;
+
+	/** Resets the pickup to its class defaults and enables it at Transform, called by UPickupPoolSubsystem. */
+	virtual void OnAcquiredFromPool(const FTransform& Transform);
+
+	/** Disables and hides the pickup while it waits in the pool, called by UPickupPoolSubsystem. */
+	virtual void OnReleasedToPool();
 	
 protected:
 
@@ -123,6 +132,12 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="Pickup")
 	bool bDestroyOnActivation = false;
 
+	/**
+	 * If true the pickup is returned to the UPickupPoolSubsystem instead of being destroyed on activation.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category="Pickup", meta=(EditCondition="bDestroyOnActivation"))
+	bool bReturnToPool = true;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Pickup")
 	FTransform DefaultTransform;
 
@@ -157,6 +172,24 @@ private:
 
 	virtual bool FinishInteraction_Implementation(AActor* OtherActor) override;
 
+	bool bPooled = false;
+
+	/** Stops network updates while no player is near, see UInteractionComponent::SetDormant. */
+	UFUNCTION()
+	void HandleTriggerDormancyChanged(bool bIsDormant);
+
+	/** Stops a pending drop or floating, the pickup is placed by something else. */
+	void CancelDrop();
+
+	/** Makes the seekers of the interaction grid query again after the collision was toggled. */
+	void RefreshInteractionGrid();
+
+	/** Pools the activated pickup, or destroys it if it can't be pooled. */
+	void RemoveActivatedPickup();
+
+	/** True if UseItem isn't overridden in Blueprint, it's then called without the reflected Execute_UseItem. */
+	bool bNativeUseItem = false;
+
 	/** Line of sight trace channel. */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category="Pickup",
 		meta=(AllowPrivateAccess))
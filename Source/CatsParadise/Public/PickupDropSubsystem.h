@@ -0,0 +1,78 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "UObject/WeakInterfacePtr.h"
+#include "OceanSamplerInterface.h"
+#include "PickupDropSubsystem.generated.h"
+
+class APickupActor;
+
+/**
+ * Puts dropped pickups on the floor.
+ * Drop requests made during a frame are traced together with async traces on the next tick and the pickups
+ * are moved once the results arrive a frame later. While there is an ocean the traces reach below its plane,
+ * pickups whose floor is under the surface or that found no floor at all are over water and float on it,
+ * following the waves through one batched ocean sample per tick. Dormant floating pickups, far from every player,
+ * aren't sampled, and pickups are only moved once the surface moved more than pickup.FloatUpdateThreshold.
+ * Pickups without a floor within the trace distance that aren't over water stay where they were dropped.
+ */
+UCLASS()
+class CATSPARADISE_API UPickupDropSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Queues a trace straight down from the pickup location, replaces an earlier request of the same pickup. */
+	void RequestDrop(APickupActor* Pickup, float TraceDistance, ETraceTypeQuery TraceChannel, const TArray<const AActor*>& IgnoredActors);
+
+	/** Forgets the pending drop of the pickup and stops it floating, e.g. when it's picked up again. */
+	void CancelDrop(const APickupActor* Pickup);
+
+	bool IsFloating(const APickupActor* Pickup) const;
+
+private:
+	struct FDropRequest
+	{
+		TWeakObjectPtr<APickupActor> Pickup;
+		FVector TraceStart = FVector::ZeroVector;
+		FVector TraceEnd = FVector::ZeroVector;
+		/** How far down the pickup is put on a floor above water, the trace may reach further to find the water. */
+		double FloorDistance = 0.0;
+		/** Set if the trace reaches below the ocean plane, only then a missed trace means water. */
+		bool bTracedToWater = false;
+		ECollisionChannel TraceChannel = ECC_WorldStatic;
+		TArray<TWeakObjectPtr<const AActor>> IgnoredActors;
+		FTraceHandle Trace;
+	};
+
+	/** Requests waiting for the next tick to be traced. */
+	TArray<FDropRequest> QueuedDrops;
+
+	/** Requests traced on the last tick waiting for their results. */
+	TArray<FDropRequest> TracedDrops;
+
+	TArray<TWeakObjectPtr<APickupActor>> FloatingPickups;
+
+	TWeakInterfacePtr<IOceanSamplerInterface> OceanSampler;
+	EOceanSamplingBackend OceanSamplerBackend = EOceanSamplingBackend::FFT;
+	bool bOceanSamplerSearched = false;
+
+	// reused by the batched ocean samples
+	TArray<FVector> SampleLocations;
+	TArray<FVector> SampleDisplacements;
+	TArray<APickupActor*> SampledPickups;
+
+	IOceanSamplerInterface* UpdateOceanSampler();
+	void TraceQueuedDrops();
+	void ResolveTracedDrops();
+	void UpdateFloatingPickups();
+	bool CanFloat(const APickupActor* Pickup) const;
+};
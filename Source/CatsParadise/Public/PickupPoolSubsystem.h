@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupPoolSubsystem.generated.h"
+
+class APickupActor;
+
+/**
+ * Keeps activated pickups around to be reused instead of destroying and spawning them again.
+ * Pooled pickups are hidden, have no collision and don't tick.
+ */
+UCLASS()
+class CATSPARADISE_API UPickupPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Spawns pickups of the class until Count of them are pooled. */
+	UFUNCTION(BlueprintCallable, Category="Pickup")
+	void PrewarmPickups(TSubclassOf<APickupActor> PickupClass, int32 Count);
+
+	/** Takes a pooled pickup of the class, or spawns one if none is pooled, and enables it at Transform. */
+	UFUNCTION(BlueprintCallable, Category="Pickup")
+	APickupActor* AcquirePickup(TSubclassOf<APickupActor> PickupClass, const FTransform& Transform);
+
+	/** Disables the pickup and pools it, returns false if the pool of its class is full. */
+	UFUNCTION(BlueprintCallable, Category="Pickup")
+	bool ReleasePickup(APickupActor* Pickup);
+
+	UFUNCTION(BlueprintCallable, Category="Pickup")
+	int32 GetNumPooledPickups(TSubclassOf<APickupActor> PickupClass) const;
+
+private:
+	TMap<TSubclassOf<APickupActor>, TArray<TWeakObjectPtr<APickupActor>>> PooledPickups;
+
+	APickupActor* SpawnPickup(TSubclassOf<APickupActor> PickupClass, const FTransform& Transform) const;
+};
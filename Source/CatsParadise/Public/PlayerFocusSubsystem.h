@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "UObject/ObjectKey.h"
+#include "PlayerFocusSubsystem.generated.h"
+
+class APlayerController;
+
+DECLARE_STATS_GROUP(TEXT("Interaction"), STATGROUP_Interaction, STATCAT_Advanced);
+
+/** How a viewer looks for the actor it focuses. */
+struct FPlayerFocusTraceSettings
+{
+	ETraceTypeQuery TraceChannel = UEngineTypes::ConvertToTraceType(ECC_Visibility);
+	float Distance = 512.f;
+	/** Zero or less traces a line, otherwise a sphere of this radius. */
+	float Radius = 0.f;
+	EDrawDebugTrace::Type DebugTrace = EDrawDebugTrace::None;
+	float DebugDrawTime = 0.f;
+
+	bool MatchesTrace(const FPlayerFocusTraceSettings& Other) const
+	{
+		return TraceChannel == Other.TraceChannel && Distance == Other.Distance && Radius == Other.Radius;
+	}
+};
+
+/**
+ * Traces what every player is looking at and shares the result between the systems that need it.
+ * A viewer is only traced again once its view moved, the caller's invalidation key changed or the
+ * result got older than interaction.FocusMaxAge, requests with the same settings share a single trace.
+ * Traces are async, every trace requested in a frame is batched by the physics scene and the
+ * results are picked up on the next frame, so the focus lags the view by a frame.
+ * Player view points are cached for the frame too, every system asking for the view of a player gets the same one.
+ */
+UCLASS()
+class CATSPARADISE_API UPlayerFocusSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Returns the actor the viewer was last found looking at, and requests a new trace if the result is out of date.
+	 * @param InvalidationKey Forces a new trace when it differs from the last non zero key given with the same settings, e.g. a queue revision. Zero never invalidates.
+	 */
+	AActor* GetFocusedActor(const AActor* Viewer, const FVector& ViewLocation, const FRotator& ViewRotation, const FPlayerFocusTraceSettings& Settings, uint32 InvalidationKey = 0);
+
+	/** The view point of the player controller, computed once per frame. */
+	void GetPlayerViewPoint(const APlayerController* Controller, FVector& OutLocation, FRotator& OutRotation);
+
+	/** Drops the cached focus of the viewer, call when it leaves play. */
+	void RemoveViewer(const AActor* Viewer);
+
+private:
+	struct FFocusEntry
+	{
+		FPlayerFocusTraceSettings Settings;
+		FVector ViewLocation = FVector::ZeroVector;
+		FQuat ViewRotation = FQuat::Identity;
+		uint32 InvalidationKey = 0;
+		double TraceTime = -1.0;
+		TWeakObjectPtr<AActor> FocusedActor;
+		FTraceHandle PendingTrace;
+	};
+
+	// a viewer rarely uses more than a couple of different settings
+	TMap<TObjectKey<AActor>, TArray<FFocusEntry, TInlineAllocator<2>>> FocusEntries;
+
+	struct FViewPoint
+	{
+		FVector Location = FVector::ZeroVector;
+		FRotator Rotation = FRotator::ZeroRotator;
+	};
+
+	/** View points of the frame ViewPointsFrame, dropped on the first request of a later frame. */
+	TMap<TObjectKey<APlayerController>, FViewPoint, TInlineSetAllocator<4>> ViewPoints;
+	uint64 ViewPointsFrame = 0;
+
+	bool IsEntryValid(const FFocusEntry& Entry, const FVector& ViewLocation, const FQuat& ViewRotation, uint32 InvalidationKey) const;
+	FTraceHandle RequestTrace(const AActor* Viewer, const FVector& ViewLocation, const FRotator& ViewRotation, const FPlayerFocusTraceSettings& Settings) const;
+	void ReceiveTrace(FFocusEntry& Entry);
+	void DrawDebugTrace(const FPlayerFocusTraceSettings& Settings, const FTraceDatum& TraceDatum) const;
+};